@@ -3,19 +3,41 @@
 #pragma once
 #include "Logger.hpp"
 #include "Chronometer.hpp"
+#include "CsvScanner.hpp"
 #include <fstream>
 #include <string>
+#include <string_view>
 #include <vector>
 
-
+/**
+ * FileReader: Streaming CSV row reader
+ *
+ * The file is read into one reusable buffer, cut after the last complete
+ * row, and split with CsvScanner. Rows come out as views into that
+ * buffer, so reading allocates nothing once the buffer has grown to
+ * the longest row, and memory does not depend on the file size.
+ */
 class FileReader{
     std::string file_path;
     int cur_lines;
     std::ifstream file_stream;
-    
-public: 
 
-    std::vector<std::string> line_processed();
+    std::vector<char> buffer;
+    size_t filled;     // bytes of buffer holding file data
+    size_t rows_end;   // end of the complete rows handed to the scanner
+    bool in_quotes;    // quote state at filled
+    std::vector<uint32_t> structural;
+    CsvScanner scanner;
+
+    bool refill();
+
+public:
+
+    /**
+     * Read the next row; the views stay valid until the next call
+     * @return false at the end of the file
+     */
+    bool nextRow(std::vector<std::string_view> &fields);
 
     bool hasNextLine();
     void reset();
@@ -31,13 +53,16 @@ public:
     int getCurrentLine() const;
 
     ~FileReader();
-    
+
 
 protected:
-    FileReader(const std::string _file_path):file_path(_file_path),cur_lines(0){
-            file_stream.open(_file_path);
+    static const size_t BUFFER_SIZE = 1 << 20;
+
+    FileReader(const std::string _file_path):file_path(_file_path),cur_lines(0),
+        buffer(BUFFER_SIZE),filled(0),rows_end(0),in_quotes(false){
+            file_stream.open(_file_path, std::ios::binary);
     };
     static FileReader* reader;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -1,4 +1,134 @@
 #ifndef B_TREE_P_H
 #define B_TREE_P_H
 
-#endif // B_TREE_P_H
\ No newline at end of file
+#include <string>
+#include <vector>
+#include <utility>
+#include <functional>
+#include "Logger.hpp"
+#include "PageFile.hpp"
+
+/**
+ * BTreePNode: On-disk layout of a B+ tree node (one page)
+ *
+ * [Node Type: 4][Key Count: 4][Next Leaf: 4]
+ * Leaf:     Count x [Key: 4][Value: 4]
+ * Internal: [Child 0: 4] then Count x [Key: 4][Child: 4]
+ *
+ * In an internal node, key i is the smallest key reachable through
+ * child i, so a lookup follows the last key <= the searched one.
+ */
+struct BTreePNode
+{
+    static const int HEADER_SIZE = 12;
+    static const int LEAF = 1;
+    static const int INTERNAL = 2;
+    static const int NO_PAGE = -1;
+
+    static int leafCapacity(int page_size) { return (page_size - HEADER_SIZE) / 8; }
+    static int internalCapacity(int page_size) { return (page_size - HEADER_SIZE - 4) / 8; }
+
+    static void format(char *page, int page_size, int type);
+    static int getType(const char *page);
+    static int getCount(const char *page);
+    static int getNextLeaf(const char *page);
+    static void setNextLeaf(char *page, int next);
+
+    static void appendLeaf(char *page, int key, int value);
+    static int getLeafKey(const char *page, int index);
+    static int getLeafValue(const char *page, int index);
+
+    static void setFirstChild(char *page, int child);
+    static void appendInternal(char *page, int key, int child);
+    static int findChild(const char *page, int key);
+};
+
+/**
+ * BTreeP: Disk-based B+ tree over integer keys (primary index on ID)
+ *
+ * Page 0 holds the tree header, nodes follow. The tree is built
+ * bottom-up from a sorted run: leaves are written left to right,
+ * then each internal level, so every page is written once and the
+ * height is the minimum for the chosen fill factor.
+ * Values are the data file page holding the record.
+ */
+class BTreeP
+{
+private:
+    Logger &logger;
+    PageFile index_file;
+    int page_size;
+    int root_page;
+    int height;
+    int key_count;
+    int first_leaf;
+    bool read_only;
+
+    // Leaves requested ahead of a range scan
+    static const int LEAF_READAHEAD = 4;
+
+    std::vector<char> page_buffer;
+
+    // Statistics
+    int blocks_read;
+    int blocks_written;
+
+    // Lookups read nodes through the Buffer pool; bulkBuild writes
+    // pages sequentially and bypasses it
+    const char *pinNode(int page_id);
+    void unpinNode(int page_id);
+    bool writeNode(int page_id, const char *page);
+    bool writeHeader();
+    bool readHeader(const std::string &path);
+    int descend(int key);
+
+public:
+    static const int META_MAGIC = 0x50544241; // "ABTP"
+    static const int META_VERSION = 1;
+
+    BTreeP(Logger &log, int pg_size = 4096);
+    ~BTreeP();
+
+    /**
+     * Build a new index file from (key, value) pairs sorted by key
+     * @param fill_factor Fraction of each node filled (0 < f <= 1)
+     */
+    bool bulkBuild(const std::string &path,
+                   const std::vector<std::pair<int, int>> &sorted_entries,
+                   double fill_factor = 1.0);
+
+    /**
+     * @param mapped Memory-map the index file (read-only opens only)
+     */
+    bool open(const std::string &path, bool readonly = true, bool mapped = false);
+    void close();
+
+    /**
+     * Point lookup: one page read per level
+     * @return true and the stored value when the key exists
+     */
+    bool search(int key, int &value);
+
+    /**
+     * Range scan: every (key, value) with low <= key <= high, in key order
+     * Descends once, then follows the leaf chain, reading the next
+     * leaves ahead when the file is mapped
+     * @param fn Called per entry, returns false to stop the scan
+     * @return number of entries visited
+     */
+    int rangeScan(int low, int high, const std::function<bool(int key, int value)> &fn);
+
+    void printStatistics() const;
+
+    // Getters
+    int getHeight() const { return height; }
+    int getKeyCount() const { return key_count; }
+    int getTotalBlocks() const { return index_file.getPageCount(); }
+    int getBlocksRead() const { return blocks_read; }
+    int getBlocksWritten() const { return blocks_written; }
+
+    BTreeP(const BTreeP &) = delete;
+    BTreeP &operator=(const BTreeP &) = delete;
+};
+
+#endif // B_TREE_P_H
@@ -0,0 +1,128 @@
+#ifndef B_TREE_P_STRING_H
+#define B_TREE_P_STRING_H
+
+#include <string>
+#include <vector>
+#include <utility>
+#include "Logger.hpp"
+#include "PageFile.hpp"
+
+/**
+ * RecordLocation: Where a record lives in the hash data file
+ */
+struct RecordLocation
+{
+    int record_id;
+    int block_id;
+};
+
+/**
+ * BTreePStringNode: On-disk layout of a string-keyed B+ tree node
+ *
+ * [Node Type: 4][Entry Count: 4][Next Leaf: 4]
+ * Leaf:     Count x [Prefix Len: 2][Suffix Len: 2][Suffix][Record ID: 4][Block ID: 4]
+ * Internal: [Child 0: 4] then Count x [Separator Len: 2][Separator][Child: 4]
+ *
+ * Leaf keys are front compressed: each entry stores only the bytes that
+ * differ from the previous key of the same leaf. Internal nodes store
+ * the shortest separator s with max(left child) <= s <= min(right child).
+ */
+struct BTreePStringNode
+{
+    static const int HEADER_SIZE = 12;
+    static const int LEAF = 1;
+    static const int INTERNAL = 2;
+    static const int NO_PAGE = -1;
+    static const int MAX_KEY_SIZE = 1024;
+
+    static int leafEntrySize(int suffix_len) { return 12 + suffix_len; }
+    static int internalEntrySize(int sep_len) { return 6 + sep_len; }
+};
+
+/**
+ * BTreePString: Disk-based secondary B+ tree over string keys (Titulo)
+ *
+ * Built bottom-up from a run sorted by key, like BTreeP. Keys may
+ * repeat; a lookup descends to the leftmost leaf that can hold the key
+ * and scans right through the leaf chain.
+ */
+class BTreePString
+{
+private:
+    Logger &logger;
+    PageFile index_file;
+    int page_size;
+    int root_page;
+    int height;
+    int key_count;
+    int first_leaf;
+
+    std::vector<char> page_buffer;
+
+    // Statistics
+    int blocks_read;
+    int blocks_written;
+
+    // Lookups read nodes through the Buffer pool; bulkBuild writes
+    // pages sequentially and bypasses it
+    const char *pinNode(int page_id);
+    void unpinNode(int page_id);
+    bool writeNode(int page_id, const char *page);
+    bool writeHeader();
+    bool readHeader(const std::string &path);
+    int descend(const std::string &key);
+    int maxKeySize() const;
+    bool scan(const std::string &key, bool match_prefix, std::vector<RecordLocation> &out);
+
+public:
+    static const int META_MAGIC = 0x53544241; // "ABTS"
+    static const int META_VERSION = 1;
+
+    BTreePString(Logger &log, int pg_size = 4096);
+    ~BTreePString();
+
+    /**
+     * Build a new index file from (key, location) pairs sorted by key
+     * Keys longer than MAX_KEY_SIZE (or what fits a node) are truncated
+     * @param fill_factor Fraction of each node filled (0 < f <= 1)
+     */
+    bool bulkBuild(const std::string &path,
+                   const std::vector<std::pair<std::string, RecordLocation>> &sorted_entries,
+                   double fill_factor = 1.0);
+
+    /**
+     * @param mapped Memory-map the index file
+     */
+    bool open(const std::string &path, bool mapped = false);
+    void close();
+
+    /**
+     * Exact match lookup, appends every location stored under key
+     */
+    bool search(const std::string &key, std::vector<RecordLocation> &out);
+
+    /**
+     * Prefix lookup, appends the locations of every key starting with
+     * prefix, in key order
+     */
+    bool searchPrefix(const std::string &prefix, std::vector<RecordLocation> &out);
+
+    /**
+     * Shortest separator between two adjacent keys (left <= right)
+     */
+    static std::string shortestSeparator(const std::string &left, const std::string &right);
+
+    void printStatistics() const;
+
+    // Getters
+    int getHeight() const { return height; }
+    int getKeyCount() const { return key_count; }
+    int getTotalBlocks() const { return index_file.getPageCount(); }
+    int getBlocksRead() const { return blocks_read; }
+    int getBlocksWritten() const { return blocks_written; }
+
+    BTreePString(const BTreePString &) = delete;
+    BTreePString &operator=(const BTreePString &) = delete;
+};
+
+#endif // B_TREE_P_STRING_H
@@ -1,25 +1,103 @@
 #ifndef BUFFER_H
 #define BUFFER_H
 #include <mutex>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+#include "Logger.hpp"
+#include "PageFile.hpp"
 
+/**
+ * Buffer: Process-wide buffer pool shared by the hash file and the indexes
+ *
+ * A fixed array of frames (frame_count x frame_size bytes) is allocated
+ * once, so the memory used for pages is capped by configure(). Pages are
+ * found through a (file, page) -> frame table. A fetched page stays
+ * pinned until unpinPage; unpinned frames are replaced with CLOCK and
+ * written back first when dirty.
+ */
 class Buffer{
 public:
-    void LoadBlockBuffer(size_t offset);
-    void removeDataBuffer();
-    // void updateBufferBlock(size_t offset);
+    struct Frame
+    {
+        PageFile *file;
+        int page_id;
+        int pin_count;
+        bool dirty;
+        bool referenced;
+    };
+
+    /**
+     * Size the pool; drops every frame (dirty ones are written back)
+     * Fails while any page is pinned
+     */
+    bool configure(int frames, int frame_size);
+
+    /**
+     * Pin a page, reading it from disk on a miss
+     * Pages of a memory-mapped file are returned from the mapping
+     * @return frame bytes, or nullptr if the page cannot be read or
+     *         every frame is pinned
+     */
+    char *fetchPage(PageFile &file, int page_id);
+
+    /**
+     * Pin a frame for a page that does not exist on disk yet
+     * The frame is zeroed and marked dirty
+     */
+    char *newPage(PageFile &file, int page_id);
+
+    void unpinPage(PageFile &file, int page_id, bool dirty);
+
+    /**
+     * Drop the frame of a page without writing it back, pinned or not
+     * Its changes are lost; the next fetch reads the page from disk
+     */
+    void discardPage(PageFile &file, int page_id);
+
+    bool flushFile(PageFile &file);
+    void dropFile(PageFile &file);
+    bool flushAll();
+
+    // Statistics
+    long getHits() const { return hits; }
+    long getMisses() const { return misses; }
+    long getEvictions() const { return evictions; }
+    int getFrameCount() const { return frame_count; }
+    int getFrameSize() const { return frame_size; }
+    void printStatistics();
+
     static Buffer* getBuffer();
     virtual ~Buffer(){};
 
 protected:
-    Buffer() = default;
+    Buffer();
 
     std::mutex buffer_mutex;
-    size_t max_size;
-    size_t min_size;
+    int frame_count;
+    int frame_size;
+    std::vector<char> pool;
+    std::vector<Frame> frames;
+    std::unordered_map<uint64_t, int> page_table;
+    int clock_hand;
+
+    long hits;
+    long misses;
+    long evictions;
+
     static Buffer* buffer;
 
+    static uint64_t pageKey(const PageFile &file, int page_id)
+    {
+        return (static_cast<uint64_t>(file.getFileId()) << 32) | static_cast<uint32_t>(page_id);
+    }
+    char *frameData(int frame) { return pool.data() + static_cast<size_t>(frame) * frame_size; }
+    int findVictim();
+    bool writeBack(int frame);
+    int claimFrame(PageFile &file, int page_id);
+
     Buffer(const Buffer&) = delete;
     Buffer& operator=(const Buffer&) = delete;
-}
+};
 
-#endif // BUFFER_H
\ No newline at end of file
+#endif // BUFFER_H
@@ -0,0 +1,23 @@
+#ifndef COLLATION_HPP
+#define COLLATION_HPP
+
+#include <string>
+#include <string_view>
+
+/**
+ * Collation: Search key normalization for titles
+ *
+ * fold() maps text to the form stored in the folded title index:
+ * - ASCII letters are lowercased
+ * - Latin-1 accented letters, as UTF-8 or as HTML entities such as
+ *   &ouml;, lose their accent (o); &szlig; becomes ss
+ * - &amp;, &quot;, &apos;, &lt; and &gt; become the character they name
+ * Anything else is kept as is, so folding is cheap and stable.
+ */
+class Collation
+{
+public:
+    static std::string fold(std::string_view text);
+};
+
+#endif // COLLATION_HPP
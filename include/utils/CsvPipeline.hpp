@@ -0,0 +1,117 @@
+#ifndef CSV_PIPELINE_HPP
+#define CSV_PIPELINE_HPP
+
+#include <string>
+#include <vector>
+#include <map>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include "Logger.hpp"
+#include "SchemaParser.hpp"
+#include "RecordLayout.hpp"
+
+/**
+ * CsvPipeline: Multi-threaded CSV ingestion for upload
+ *
+ * reader -> parsers -> writer
+ * - The reader thread pulls large chunks and cuts them after the last
+ *   newline outside quotes, carrying the quote state across chunks.
+ *   When the file can be memory-mapped it is instead split into equal
+ *   ranges, each moved to the next true row start, and the parsers
+ *   read the mapping directly
+ * - Parser threads split each chunk into rows with CsvScanner and
+ *   encode them with the schema's RecordLayout
+ * - The calling thread takes parsed chunks back in file order and hands
+ *   every serialized record to the sink (bulkAdd partitions them by
+ *   hash bucket), so the result matches a serial load
+ */
+class CsvPipeline
+{
+public:
+    // Receives one record in RecordLayout format, false = skipped
+    using Sink = std::function<bool(const char *bytes, int size)>;
+
+private:
+    // Rows to parse: a range of the mapped file, or bytes read into data
+    struct Chunk
+    {
+        int seq;
+        int first_line;
+        const char *mapped;
+        size_t size;
+        std::string data;
+    };
+
+    // Rows of one mapped range, counted as if it started outside quotes
+    struct RangeCount
+    {
+        int rows_plain;
+        int rows_quoted; // newlines inside quotes; rows if it starts inside
+        bool odd_quotes;
+    };
+
+    struct Batch
+    {
+        std::vector<char> records;
+        std::vector<int> sizes;
+        int skipped;
+    };
+
+    Logger &logger;
+    const std::vector<FieldSpec> &schema;
+    RecordLayout layout;
+    int parser_threads;
+    bool use_mmap;
+    size_t chunk_size;
+
+    // Chunks read but not yet written are bounded to keep memory flat
+    std::mutex queue_mutex;
+    std::condition_variable chunk_ready;
+    std::condition_variable slot_free;
+    std::condition_variable batch_ready;
+    std::deque<Chunk> chunks;
+    std::map<int, Batch> batches;
+    int max_in_flight;
+    bool reader_done;
+    bool failed;
+    int chunks_total;
+    int next_to_write;
+
+    int records_read;
+    int inserted;
+    int skipped;
+
+    void readerLoop(const std::string &path);
+    void readMapped(const char *base, size_t len);
+    void pushChunk(Chunk chunk);
+    void parserLoop();
+    Batch parseChunk(const Chunk &chunk);
+
+public:
+    /**
+     * @param threads Parser threads, 0 = one per hardware thread
+     * @param mapped Memory-map the input instead of reading it
+     * @param chunk_bytes Size of the reads (or mapped ranges) handed out
+     */
+    CsvPipeline(Logger &log, const std::vector<FieldSpec> &schema_fields,
+                int threads = 0, bool mapped = true, size_t chunk_bytes = 4 << 20);
+
+    /**
+     * Load the whole CSV file, feeding records to sink in file order
+     * @return false if the file cannot be read
+     */
+    bool run(const std::string &path, const Sink &sink);
+
+    // Statistics
+    int getRecordsRead() const { return records_read; }
+    int getInserted() const { return inserted; }
+    int getSkipped() const { return skipped; }
+    int getParserThreads() const { return parser_threads; }
+
+    CsvPipeline(const CsvPipeline &) = delete;
+    CsvPipeline &operator=(const CsvPipeline &) = delete;
+};
+
+#endif // CSV_PIPELINE_HPP
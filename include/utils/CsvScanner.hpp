@@ -0,0 +1,79 @@
+#ifndef CSV_SCANNER_HPP
+#define CSV_SCANNER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * CsvScanner: Splits a buffer of CSV rows using structural offsets
+ *
+ * scan() finds every ';', '"', '\n' and '\r' in one pass, 32 (AVX2) or
+ * 16 (SSE2) bytes at a time, with a scalar fallback picked at runtime.
+ * nextRow() then walks only those offsets: fields split on ';', quotes
+ * removed ("" is a literal quote), line breaks and '\r' kept inside
+ * quotes. A field that is one run of bytes (plain or "quoted") comes
+ * out as a view into the buffer; only fields with "" escapes or several
+ * quoted parts are assembled in a scratch string reused across rows.
+ * The buffer is never written, so it can be a read-only mapping.
+ */
+class CsvScanner
+{
+public:
+    enum class Level
+    {
+        Scalar,
+        SSE2,
+        AVX2
+    };
+
+private:
+    // Where a field's bytes live until the row is complete
+    struct Piece
+    {
+        size_t begin;
+        size_t size;
+        bool in_scratch;
+    };
+
+    const char *data;
+    size_t length;
+    size_t position;
+    size_t next_offset;
+    std::vector<uint32_t> offsets;
+    std::vector<Piece> pieces;
+    std::string scratch;
+
+public:
+    CsvScanner() : data(nullptr), length(0), position(0), next_offset(0) {}
+
+    /**
+     * Best level supported by this CPU
+     */
+    static Level detect();
+    static const char *levelName(Level level);
+
+    /**
+     * Append the offsets of every structural byte in data[0, len)
+     * Buffers must stay below 4 GiB
+     */
+    static void scan(const char *data, size_t len, std::vector<uint32_t> &out);
+    static void scan(const char *data, size_t len, std::vector<uint32_t> &out, Level level);
+
+    /**
+     * Start splitting a new buffer (not copied, must outlive the rows)
+     */
+    void reset(const char *buffer, size_t len);
+
+    /**
+     * Split the next row; the views point into the buffer or the
+     * scratch string and stay valid until the next call
+     * @return false once the buffer is exhausted
+     */
+    bool nextRow(std::vector<std::string_view> &fields);
+    bool hasMore() const { return position < length; }
+};
+
+#endif // CSV_SCANNER_HPP
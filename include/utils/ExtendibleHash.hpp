@@ -2,15 +2,119 @@
 #define EXTENDIBLE_HASH_V2_HPP
 
 #include <vector>
-#include <memory>
+#include <deque>
 #include <sstream>
 #include <map>
+#include <fstream>
+#include <functional>
+#include <cstdint>
+#include <algorithm>
 #include "Logger.hpp"
-#include "Record.hpp"
+#include "RecordView.hpp"
+#include "PageFile.hpp"
+#include "SlottedPage.hpp"
+#include "HashDirectory.hpp"
+#include "KeyHash.hpp"
+#include "WriteAheadLog.hpp"
 
 /**
- * HashBucket: Now uses actual Record objects
- * Respects block boundaries and accurately calculates occupancy
+ * BucketPage: Bucket operations over a SlottedPage block
+ *
+ * The slotted page Aux field holds the bucket local depth and Next the
+ * first overflow page of the bucket, if any. Records are stored in
+ * RecordLayout format, which starts with the record ID, so lookups only
+ * read the first 4 bytes of each slot.
+ */
+struct BucketPage
+{
+    static const int HEADER_SIZE = SlottedPage::HEADER_SIZE;
+
+    static void format(char *page, int page_size, int local_depth);
+    static int getLocalDepth(const char *page, int page_size);
+    static bool append(char *page, int page_size, const char *data, int size);
+    static int findSlot(const char *page, int page_size, int id);
+    static bool find(const char *page, int page_size, int id, RecordView &out);
+    static bool contains(const char *page, int page_size, int id);
+    static bool remove(char *page, int page_size, int id);
+    static int getNext(const char *page, int page_size);
+    static void setNext(char *page, int page_size, int page_id);
+};
+
+/**
+ * BucketFilter: Bloom filter over the IDs stored in one bucket
+ *
+ * 512 bits and 4 probes, about 0.5% false positives for 40 records.
+ * Probes come from a mix of the whole ID, not its low bits, since every
+ * ID of a bucket shares those. Removing a record leaves its bits set,
+ * which only costs an occasional false positive until the next split.
+ */
+struct BucketFilter
+{
+    static const int WORDS = 8;
+    static const int PROBES = 4;
+
+    uint64_t bits[WORDS];
+
+    BucketFilter() { clear(); }
+
+    void clear()
+    {
+        for (auto &word : bits)
+            word = 0;
+    }
+
+    void add(int id)
+    {
+        uint64_t h = mix(id);
+        for (int i = 0; i < PROBES; ++i)
+        {
+            uint32_t bit = probe(h, i);
+            bits[bit / 64] |= uint64_t(1) << (bit % 64);
+        }
+    }
+
+    // Union with another filter, for a merged bucket
+    void merge(const BucketFilter &other)
+    {
+        for (int i = 0; i < WORDS; ++i)
+            bits[i] |= other.bits[i];
+    }
+
+    bool mayContain(int id) const
+    {
+        uint64_t h = mix(id);
+        for (int i = 0; i < PROBES; ++i)
+        {
+            uint32_t bit = probe(h, i);
+            if (!(bits[bit / 64] & (uint64_t(1) << (bit % 64))))
+                return false;
+        }
+        return true;
+    }
+
+private:
+    static uint64_t mix(int id)
+    {
+        // splitmix64 finalizer
+        uint64_t z = static_cast<uint32_t>(id) + 0x9E3779B97F4A7C15ULL;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    // Double hashing: probe i = h1 + i * h2
+    static uint32_t probe(uint64_t h, int i)
+    {
+        uint32_t h1 = static_cast<uint32_t>(h);
+        uint32_t h2 = static_cast<uint32_t>(h >> 32) | 1;
+        return (h1 + i * h2) % (WORDS * 64);
+    }
+};
+
+/**
+ * HashBucket: In-memory descriptor of a bucket page
+ * Records live only on disk; the descriptor keeps what the directory
+ * needs to route and split without reading the page.
  */
 struct HashBucket
 {
@@ -19,333 +123,392 @@ struct HashBucket
     int block_id;
     int max_block_size;
 
-    std::vector<Record> records;
+    // Totals over the bucket page and its overflow chain
     int used_space;
+    int record_count;
+    int overflow_pages;
+    BucketFilter filter;
 
     HashBucket(int id, int depth = 0, int blk_id = 0, int blk_size = 4096)
         : bucket_id(id), local_depth(depth), block_id(blk_id),
-          max_block_size(blk_size), used_space(0) {}
+          max_block_size(blk_size), used_space(0), record_count(0), overflow_pages(0) {}
 
-    /**
-     * Try to insert record into bucket
-     * Returns true only if there's actual space in block
-     */
-    bool insertRecord(const Record &rec)
+    int getCapacity() const
     {
-        // Check if record fits in remaining block space
-        if (used_space + rec.getTotalSize() > max_block_size)
-        {
-            return false; // Block full
-        }
-        records.push_back(rec);
-        used_space += rec.getTotalSize();
-        return true;
+        return max_block_size - BucketPage::HEADER_SIZE;
     }
 
-    bool isFull() const
+    bool fits(int size) const
     {
-        // Conservative: leave 5% margin for metadata
-        return used_space > (max_block_size * 0.95);
+        return used_space + SlottedPage::footprint(size) <= getCapacity();
     }
 
-    double getOccupancy() const
+    bool isFull() const
     {
-        return static_cast<double>(used_space) / max_block_size;
+        // Conservative: leave 5% margin for metadata
+        return used_space > (getCapacity() * 0.95);
     }
 
-    const Record *findRecord(int id) const
+    double getOccupancy() const
     {
-        for (const auto &rec : records)
-        {
-            if (rec.getId() == id)
-            {
-                return &rec;
-            }
-        }
-        return nullptr;
+        return static_cast<double>(used_space) / (getCapacity() * (1 + overflow_pages));
     }
 
     std::string toString() const
     {
         std::ostringstream oss;
         oss << "Bucket[ID=" << bucket_id
+            << " Block=" << block_id
             << " LocalDepth=" << local_depth
-            << " Used=" << used_space << "/" << max_block_size
+            << " Used=" << used_space << "/" << getCapacity()
             << " Occupancy=" << (getOccupancy() * 100) << "%"
-            << " Records=" << records.size() << "]";
+            << " Records=" << record_count
+            << " Overflow=" << overflow_pages << "]";
         return oss.str();
     }
 };
 
 /**
- * ExtendibleHash: Updated to work with proper Record structure
+ * SplitPolicy: When inserts split a bucket that still has room
+ * - Overflow: never; a bucket splits only when a record does not fit
+ * - LoadFactor: the bucket inserted into splits while the file load
+ *   (record bytes over bucket capacity) is at or above the load factor
+ * - Hybrid: as LoadFactor, but only buckets that are themselves at or
+ *   above the load factor split, so sparse buckets are left alone
+ */
+enum class SplitPolicy
+{
+    Overflow,
+    LoadFactor,
+    Hybrid
+};
+
+/**
+ * ExtendibleHash: Disk-resident extendible hash file
+ *
+ * Buckets are picked by the low bits of a hash of the ID (KeyHash);
+ * the function is chosen when the file is created and kept in .meta.
+ *
+ * Files (base path + suffix):
+ * - .data: one slotted bucket page per block, page N at offset N * block_size
+ * - .meta: header, bucket descriptors and the directory (page ids)
+ * - .wal: redo log of the changes since the last checkpoint
+ *
+ * The directory is loaded once on open, so a search costs one
+ * directory lookup plus one page read. It holds plain page ids in
+ * segments (see HashDirectory), so doubling it does not copy the
+ * existing entries; bucket descriptors are kept apart, by page id. Each bucket descriptor carries a
+ * Bloom filter of its IDs, so most lookups of absent IDs (and the
+ * duplicate check on insert) are answered without reading the page. Random page access goes through
+ * the Buffer pool; create and bulk load write pages sequentially and
+ * bypass it.
+ *
+ * A full bucket splits while that separates its keys and its local
+ * depth is below the maximum depth; otherwise the record goes to an
+ * overflow page chained from the bucket page. Skewed keys thus grow a
+ * chain instead of doubling the directory without bound. A split moves
+ * only the smaller side of the bucket to the new one, so splitting a long
+ * chain of keys that stay together rewrites a couple of pages.
+ *
+ * Inserts and removes on a writable file are grouped: every page an
+ * operation dirties stays pinned in the Buffer pool until its group
+ * commits, so the data file never sees a change the log does not have.
+ * A group commit logs, with a single sync, the images of those pages,
+ * the descriptors the group changed and its directory and free list
+ * changes, every group_size operations (or sooner, when the pinned pages
+ * would crowd the pool, also ahead of a split that would add too many).
+ * A split that alone would hold half the pool chains the record instead.
+ * A checkpoint (create, bulk load, close, or a log grown past the data
+ * file) writes the pages and .meta out and empties the log; a read-write open redoes the groups committed since
+ * over .meta, so a crash loses at most the open group.
  */
 class ExtendibleHash
 {
 private:
     Logger &logger;
-    std::vector<std::shared_ptr<HashBucket>> directory;
+    PageFile data_file;
+    std::string base_path;
+    HashDirectory directory;
+    // Descriptors by page id; a deque keeps references valid as it grows
+    std::deque<HashBucket> buckets;
     int global_depth;
     int block_size;
+    int initial_buckets;
     double max_load_factor;
+    SplitPolicy split_policy;
+    KeyHash::Function hash_function;
+    int max_depth;
+    int total_records;
+    // Footprint of every record, kept in step with the buckets' used space
+    long long used_bytes;
+    bool read_only;
+    // A group commit or a split failed part way: the in-memory state is
+    // ahead of what is durable, so writes and checkpoints are refused
+    bool failed;
+    // The last open failed on committed groups the log still holds
+    bool needs_recovery;
+
+    // Pages of merged away buckets, reused by the next splits; those at
+    // the end of the data file are cut off it on checkpoint
+    std::vector<int> free_pages;
+
+    // Page of the last search/fetch, pinned while the caller reads its view
+    int pinned_block;
+
+    // Bulk load page and scratch copy of a bucket being merged
+    std::vector<char> page_buffer;
+    std::vector<char> split_buffer;
+
+    // Bulk load state: records spilled to range partitions of the directory
+    bool bulk_loading;
+    int partition_bits;
+    std::vector<std::ofstream> partitions;
+
+    // Whether a policy split refused at max_depth was logged already
+    bool depth_cap_reported;
+
+    // Directory and free list changes, logged in order with their group
+    enum ChangeOp
+    {
+        POINT_SUFFIX = 1, // entries ending in suffix (depth bits) -> page
+        DIRECTORY_GROW,
+        DIRECTORY_SHRINK,
+        FREE_PUSH,
+        FREE_POP
+    };
+    struct MetaChange
+    {
+        int op;
+        int page_id;
+        int suffix;
+        int depth;
+    };
+
+    // Group commit state: pages dirtied by the open group, held pinned,
+    // and the descriptors and metadata it changed
+    WriteAheadLog wal;
+    int group_size;
+    int group_operations;
+    std::vector<int> group_pages;
+    std::vector<bool> in_group;
+    std::vector<int> group_buckets;
+    std::vector<bool> bucket_in_group;
+    std::vector<MetaChange> group_changes;
+    // LSN of the last group commit the metadata reflects
+    long long applied_lsn;
 
     // Statistics
     int blocks_read;
     int blocks_written;
     int total_buckets;
     int splits_performed;
+    int merges_performed;
+    int filter_rejects;
+    int overflow_pages;
+    int checkpoints;
 
     int getHashValue(int key, int depth) const;
-    void splitBucket(int bucket_index);
+    bool shouldSplit(const HashBucket &bucket) const;
+    HashBucket &bucketAt(int index) { return buckets[directory.get(index)]; }
+    const HashBucket &bucketAt(int index) const { return buckets[directory.get(index)]; }
+    HashBucket &newBucket(int page_id, int local_depth);
+    char *pinPage(int block_id);
+    void unpinPage(int block_id, bool dirty);
+    void releasePinned();
+    bool insertRecord(const char *bytes, int size);
+    bool removeRecord(int id);
+    bool endOperation();
+    bool commitGroup();
+    void dropGroup();
+    int holdLimit() const;
+    bool recover();
+    void touchBucket(const HashBucket &bucket);
+    void logChange(ChangeOp op, int page_id = -1, int suffix = 0, int depth = 0);
+    void pointSuffix(int suffix, int depth, int page_id);
+    void freePage(int page_id);
+    bool applyChanges(const char *data, int size);
+    HashBucket *readBucket(std::istream &in);
+    bool writeBucket(const HashBucket &bucket, const char *page);
+    int allocateBucketPage();
+    int trailingFreePages();
+    bool chainContains(const char *page, int id);
+    bool findInChain(int block_id, int id, RecordView &out);
+    bool appendToChain(HashBucket &bucket, char *page, const char *bytes, int size);
+    bool splitSeparates(const HashBucket &bucket, int id);
+    bool splitBucket(int bucket_index);
+    bool abortSplit(const HashBucket &bucket);
+    bool mergeBucket(int bucket_index);
     void doubleDirectory();
+    void shrinkDirectory();
+    std::string partitionPath(int partition) const;
+    bool loadPartition(int partition);
+    bool saveMetadata();
+    bool loadMetadata();
     void logBucketState(const std::string &op, const HashBucket &bucket);
 
 public:
-    ExtendibleHash(Logger &log, int initial_buckets = 16,
-                   int blk_size = 4096, double load_factor = 0.7);
-
-    bool insert(const Record &rec);
-    const Record *search(int id);
-    void printStructure() const;
-    void printStatistics() const;
-
-    // Getters
-    int getGlobalDepth() const { return global_depth; }
-    int getDirectorySize() const { return directory.size(); }
-    int getTotalBuckets() const { return total_buckets; }
-    int getBlocksRead() const { return blocks_read; }
-    int getBlocksWritten() const { return blocks_written; }
-    int getSplitsPerformed() const { return splits_performed; }
-};
+    static const int META_MAGIC = 0x48424D41; // "AMBH"
+    static const int META_VERSION = 7;
 
-#endif // EXTENDIBLE_HASH_V2_HPP
+    // Default limit of the global depth (a directory of 1M entries)
+    static const int DEFAULT_MAX_DEPTH = 20;
 
-// ============== IMPLEMENTATION ==============
+    // Default operations per group commit
+    static const int DEFAULT_GROUP_SIZE = 1024;
 
-ExtendibleHash::ExtendibleHash(Logger &log, int initial_buckets,
-                               int blk_size, double load_factor)
-    : logger(log), global_depth(0), block_size(blk_size),
-      max_load_factor(load_factor), blocks_read(0), blocks_written(0),
-      total_buckets(0), splits_performed(0)
-{
+    // A log past this size and the data file size triggers a checkpoint
+    static const long long CHECKPOINT_MIN_BYTES = 8LL << 20;
 
-    // Calculate initial depth
-    int temp = initial_buckets;
-    while ((1 << global_depth) < initial_buckets)
-    {
-        global_depth++;
-    }
-
-    int num_buckets = 1 << global_depth;
-
-    // Create buckets
-    for (int i = 0; i < num_buckets; ++i)
-    {
-        auto bucket = std::make_shared<HashBucket>(i, global_depth, i, block_size);
-        directory.push_back(bucket);
-    }
-
-    total_buckets = num_buckets;
-
-    std::ostringstream oss;
-    oss << "ExtendibleHash initialized - Global Depth: " << global_depth
-        << " Buckets: " << num_buckets << " Block Size: " << block_size
-        << " bytes Load Factor: " << load_factor;
-    LOG_INFO(&logger, oss.str());
-}
-
-int ExtendibleHash::getHashValue(int key, int depth) const
-{
-    if (depth == 0)
-        return 0;
-    int mask = (1 << depth) - 1;
-    return key & mask;
-}
-
-bool ExtendibleHash::insert(const Record &rec)
-{
-    int hash_val = getHashValue(rec.getId(), global_depth);
+    // Buddy buckets are merged when their records fit in this fraction
+    // of one page, leaving room to grow before the next split
+    static constexpr double MERGE_THRESHOLD = 0.5;
 
-    if (hash_val >= static_cast<int>(directory.size()))
-    {
-        LOG_ERROR(&logger, "Hash value out of bounds");
-        return false;
-    }
-
-    auto bucket = directory[hash_val];
-    blocks_read++;
-
-    // Try to insert into bucket
-    if (bucket->insertRecord(rec))
-    {
-        blocks_written++;
-
-        logBucketState("INSERT", *bucket);
-
-        // Check if we should split
-        double global_load = 0;
-        for (const auto &b : directory)
-        {
-            global_load += b->getOccupancy();
-        }
-        global_load /= directory.size();
-
-        if (global_load >= max_load_factor)
-        {
-            LOG_WARN(&logger, "Global load factor exceeded. Triggering split.");
-            splitBucket(hash_val);
-        }
-
-        return true;
-    }
-    else
-    {
-        // Bucket full - must split and retry
-        LOG_WARN(&logger, "Bucket " + std::to_string(hash_val) + " full. Splitting.");
-        splitBucket(hash_val);
-
-        // Retry insertion with new bucket arrangement
-        hash_val = getHashValue(rec.getId(), global_depth);
-        if (hash_val < static_cast<int>(directory.size()))
-        {
-            auto new_bucket = directory[hash_val];
-            if (new_bucket->insertRecord(rec))
-            {
-                blocks_written++;
-                logBucketState("INSERT_AFTER_SPLIT", *new_bucket);
-                return true;
-            }
-        }
-
-        return false;
-    }
-}
-
-const Record *ExtendibleHash::search(int id)
-{
-    int hash_val = getHashValue(id, global_depth);
-    blocks_read++;
-
-    if (hash_val >= static_cast<int>(directory.size()))
-    {
-        LOG_ERROR(&logger, "Hash value out of bounds");
-        return nullptr;
-    }
+    ExtendibleHash(Logger &log, int initial_buckets = 16,
+                   int blk_size = 4096, double load_factor = 0.7);
+    ~ExtendibleHash();
 
-    return directory[hash_val]->findRecord(id);
-}
+    /**
+     * Create an empty hash file (truncating any existing one)
+     * @param path Base path, suffixes .data and .meta are appended
+     */
+    bool create(const std::string &path);
 
-void ExtendibleHash::splitBucket(int bucket_index)
-{
-    auto bucket = directory[bucket_index];
+    /**
+     * Open an existing hash file and load its directory
+     * Block size and depth come from the metadata, not the constructor.
+     * A read-write open first replays the groups committed to the log
+     * after the last checkpoint into the data file and .meta; a
+     * read-only open fails while the log holds any, so readers never
+     * write the store
+     * @param mapped Memory-map the data file (read-only opens only)
+     * @return false if the file is missing or damaged, or if its log
+     *         holds groups that were not replayed (see needsRecovery)
+     */
+    bool open(const std::string &path, bool readonly = true, bool mapped = false);
 
-    if (bucket->local_depth == global_depth)
-    {
-        doubleDirectory();
-    }
+    // Whether open failed on a log that a read-write open must replay
+    bool needsRecovery() const { return needs_recovery; }
+    void close();
 
-    int new_depth = bucket->local_depth + 1;
-    int split_index = bucket_index + (1 << bucket->local_depth);
+    /**
+     * Bulk load: build a new hash file writing every bucket page once
+     * @param expected_bytes Estimated total record bytes (e.g. CSV size),
+     *        used to size the directory up front
+     * Records that do not fit their bucket are chained on overflow pages
+     * written after it; later inserts split such buckets as usual
+     */
+    bool beginBulkLoad(const std::string &path, long long expected_bytes);
+    bool bulkAdd(const char *bytes, int size);
+    bool endBulkLoad();
 
-    // Create new bucket
-    auto new_bucket = std::make_shared<HashBucket>(
-        split_index, new_depth, split_index, block_size);
+    /**
+     * Commit the open group, write every cached page and .meta out with
+     * a sync, then empty the log
+     * Also runs after a group commit once the log outgrows both
+     * CHECKPOINT_MIN_BYTES and the data file, bounding log size and redo
+     */
+    bool checkpoint();
 
-    // Redistribute records
-    std::vector<Record> records_to_keep;
+    /**
+     * Record bytes in RecordLayout format
+     * @return false for a duplicate ID or when the write failed (see hasFailed)
+     */
+    bool insert(const char *bytes, int size);
 
-    for (const auto &rec : bucket->records)
-    {
-        int hash_val = getHashValue(rec.getId(), new_depth);
-        if (hash_val >= (1 << (new_depth - 1)))
-        {
-            new_bucket->records.push_back(rec);
-            new_bucket->used_space += rec.getTotalSize();
-        }
-        else
-        {
-            records_to_keep.push_back(rec);
-        }
-    }
+    /**
+     * Point lookup without allocations
+     * The view points into a pinned buffer pool frame and stays valid
+     * until the next call on this hash
+     */
+    bool search(int id, RecordView &out);
 
-    bucket->records = records_to_keep;
-    bucket->used_space = 0;
-    for (const auto &rec : bucket->records)
-    {
-        bucket->used_space += rec.getTotalSize();
-    }
-    bucket->local_depth = new_depth;
+    /**
+     * Batched point lookups
+     * Keys are visited grouped by bucket page, so every page needed is
+     * read once however many keys hit it. For each key fn gets its
+     * position in ids and whether it was found; out holds the record
+     * only during the call
+     */
+    void searchBatch(const std::vector<int> &ids, RecordView &out,
+                     const std::function<void(size_t index, bool found)> &fn);
 
-    directory[split_index] = new_bucket;
-    blocks_written += 2;
-    total_buckets++;
-    splits_performed++;
+    /**
+     * Delete a record in place; its bytes are reclaimed by the slotted
+     * page on the next insert that needs them
+     * A bucket left with its buddy below MERGE_THRESHOLD of a page is
+     * merged into it (buckets with overflow pages never merge), and the
+     * directory halves once no bucket uses the full global depth. An
+     * emptied overflow page leaves its chain. Merges move records to
+     * another page, so block ids held by the indexes are only a hint
+     * afterwards
+     */
+    bool remove(int id);
 
-    logBucketState("SPLIT_OLD", *bucket);
-    logBucketState("SPLIT_NEW", *new_bucket);
-}
+    /**
+     * Read a record straight from a known bucket page (index lookups)
+     * Same view lifetime as search
+     */
+    bool fetch(int block_id, int id, RecordView &out);
 
-void ExtendibleHash::doubleDirectory()
-{
-    int old_size = directory.size();
-    std::vector<std::shared_ptr<HashBucket>> new_directory = directory;
+    /**
+     * Start reading a bucket page ahead of a fetch (mapped files only)
+     */
+    void prefetch(int block_id) { data_file.advise(block_id, 1, PageFile::Access::WillNeed); }
 
-    for (int i = 0; i < old_size; ++i)
-    {
-        new_directory.push_back(directory[i]);
-    }
+    /**
+     * Sequential scan of every bucket page in file order
+     * The callback gets the record ID, its page and serialized bytes
+     */
+    bool forEachRecord(const std::function<void(int id, int block_id, const char *data, int size)> &fn);
 
-    directory = new_directory;
-    global_depth++;
+    void printStructure() const;
+    void printStatistics() const;
 
-    std::ostringstream oss;
-    oss << "Directory doubled - New Global Depth: " << global_depth
-        << " New Size: " << directory.size();
-    LOG_INFO(&logger, oss.str());
-}
+    // Getters
+    int getGlobalDepth() const { return global_depth; }
+    int getDirectorySize() const { return directory.size(); }
+    int getTotalBuckets() const { return total_buckets; }
+    int getTotalRecords() const { return total_records; }
+    int getBlockSize() const { return block_size; }
+    int getBlocksRead() const { return blocks_read; }
+    int getBlocksWritten() const { return blocks_written; }
+    int getSplitsPerformed() const { return splits_performed; }
+    int getMergesPerformed() const { return merges_performed; }
+    int getFilterRejects() const { return filter_rejects; }
+    int getOverflowPages() const { return overflow_pages; }
+    long getGroupCommits() const { return wal.getCommits(); }
+    int getCheckpoints() const { return checkpoints; }
+    // Whether a write failed and the file refuses more of them until reopened
+    bool hasFailed() const { return failed; }
+
+    // Takes effect on create or beginBulkLoad; open uses the file's own
+    void setHashFunction(KeyHash::Function function) { hash_function = function; }
+    KeyHash::Function getHashFunction() const { return hash_function; }
+    void setSplitPolicy(SplitPolicy policy) { split_policy = policy; }
+    // Depth past which full buckets chain overflow pages instead of splitting
+    void setMaxDepth(int depth) { max_depth = std::max(1, std::min(depth, 30)); }
+    int getMaxDepth() const { return max_depth; }
+    // Operations per group commit; 0 turns the log off (set before create/open)
+    void setGroupSize(int operations) { group_size = std::max(0, operations); }
+    int getGroupSize() const { return group_size; }
+    SplitPolicy getSplitPolicy() const { return split_policy; }
 
-void ExtendibleHash::logBucketState(const std::string &op,
-                                    const HashBucket &bucket)
-{
-    std::ostringstream oss;
-    oss << "BucketOp[" << op << "] " << bucket.toString();
-    LOG_DEBUG(&logger, oss.str());
-}
+    /**
+     * Policy from its name: overflow, load or hybrid
+     * @return false if the name is unknown
+     */
+    static bool parseSplitPolicy(const std::string &name, SplitPolicy &policy);
 
-void ExtendibleHash::printStructure() const
-{
-    std::ostringstream oss;
-    oss << "\n=== EXTENDIBLE HASH STRUCTURE V2 ===\n"
-        << "Global Depth: " << global_depth << "\n"
-        << "Directory Size: " << directory.size() << "\n"
-        << "Total Buckets: " << total_buckets << "\n"
-        << "Block Size: " << block_size << " bytes\n\n";
-
-    double total_occupancy = 0;
-    for (size_t i = 0; i < directory.size(); ++i)
+    // Record bytes over the capacity of all buckets
+    double getLoadFactor() const
     {
-        if (directory[i])
-        {
-            oss << directory[i]->toString() << "\n";
-            total_occupancy += directory[i]->getOccupancy();
-        }
+        long long capacity = static_cast<long long>(total_buckets + overflow_pages) *
+                             (block_size - BucketPage::HEADER_SIZE);
+        return capacity > 0 ? static_cast<double>(used_bytes) / capacity : 0.0;
     }
 
-    oss << "\nAverage Occupancy: "
-        << (total_occupancy / directory.size() * 100) << "%\n";
-
-    LOG_INFO(&logger, oss.str());
-}
+    ExtendibleHash(const ExtendibleHash &) = delete;
+    ExtendibleHash &operator=(const ExtendibleHash &) = delete;
+};
 
-void ExtendibleHash::printStatistics() const
-{
-    std::ostringstream oss;
-    oss << "\n=== HASH STATISTICS ===\n"
-        << "Blocks Read: " << blocks_read << "\n"
-        << "Blocks Written: " << blocks_written << "\n"
-        << "Total Buckets: " << total_buckets << "\n"
-        << "Splits Performed: " << splits_performed << "\n"
-        << "Global Depth: " << global_depth << "\n";
-
-    LOG_INFO(&logger, oss.str());
-}
\ No newline at end of file
+#endif // EXTENDIBLE_HASH_V2_HPP
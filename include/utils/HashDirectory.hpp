@@ -0,0 +1,70 @@
+#ifndef HASH_DIRECTORY_HPP
+#define HASH_DIRECTORY_HPP
+
+#include <vector>
+#include <memory>
+
+/**
+ * HashDirectory: Extendible hash directory of bucket page ids
+ *
+ * Entries live in fixed-size segments reached through a segment table.
+ * Doubling the directory only appends empty table entries: an entry of
+ * a segment that was never written holds the value of the entry with
+ * its top index bit cleared, which is exactly what a doubled directory
+ * copies there. A segment is filled in (one segment copy) on the first
+ * write to it or to the segment it mirrors, so a doubling itself never
+ * copies or touches the existing entries.
+ *
+ * Directories smaller than one segment live in segment 0 and double by
+ * copying within it.
+ */
+class HashDirectory
+{
+public:
+    static const int SEGMENT_BITS = 10;
+    static const int SEGMENT_SIZE = 1 << SEGMENT_BITS;
+
+private:
+    std::vector<std::unique_ptr<int[]>> segments; // nullptr = mirrors a lower entry
+    int depth;
+
+    // Index whose segment holds the value of index
+    int resolve(int index) const
+    {
+        while (!segments[index >> SEGMENT_BITS])
+        {
+            // Clear the highest set bit
+            index &= ~(1 << (31 - __builtin_clz(index)));
+        }
+        return index;
+    }
+
+    void materialize(int segment);
+
+public:
+    HashDirectory() { reset(0, 0); }
+
+    /**
+     * 2^depth entries, all pointing to page
+     */
+    void reset(int new_depth, int page);
+
+    int size() const { return 1 << depth; }
+    int getDepth() const { return depth; }
+
+    int get(int index) const
+    {
+        int at = resolve(index);
+        return segments[at >> SEGMENT_BITS][at & (SEGMENT_SIZE - 1)];
+    }
+
+    void set(int index, int page);
+
+    // Entry i + size() refers to the same page as entry i
+    void grow();
+
+    // Drop the upper half; it must mirror the lower half
+    void shrink();
+};
+
+#endif // HASH_DIRECTORY_HPP
@@ -0,0 +1,105 @@
+#ifndef INVERTED_INDEX_HPP
+#define INVERTED_INDEX_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include "Logger.hpp"
+
+/**
+ * InvertedIndex: On-disk full-text index from terms to record IDs
+ *
+ * File layout:
+ * [Header: 32]   magic, version, term count, record count, table and pool offsets
+ * [Postings]     per term, ascending record IDs as varint deltas
+ * [Term table]   term count x [Postings Offset: 8][Pool Offset: 4]
+ *                [Record Count: 4][Postings Bytes: 4][Term Len: 2][Pad: 2]
+ * [Term pool]    term bytes, in term order
+ *
+ * The table is sorted by term and has fixed-size entries, so a lookup
+ * binary searches it in place in the mapped file and decodes a single
+ * posting list; nothing is loaded on open.
+ *
+ * Terms are the folded (lowercase, accent free) runs of letters and
+ * digits of the indexed text, see tokenize.
+ */
+class InvertedIndex
+{
+public:
+    static const int META_MAGIC = 0x58544641; // "AFTX"
+    static const int META_VERSION = 1;
+    static const int HEADER_SIZE = 32;
+    static const int ENTRY_SIZE = 24;
+    static const int MAX_TERM_SIZE = 64;
+
+    /**
+     * Collects (term, record) pairs in memory and writes the index once
+     */
+    class Builder
+    {
+        std::unordered_map<std::string, std::vector<int>> postings;
+        std::vector<std::string> terms; // scratch for add
+        int records;
+
+    public:
+        Builder() : records(0) {}
+
+        // Index every term of text under id; call once per record and column
+        void add(int id, std::string_view text);
+        void countRecord() { records++; }
+
+        bool write(Logger &logger, const std::string &path);
+        size_t getTermCount() const { return postings.size(); }
+    };
+
+private:
+    Logger &logger;
+    std::string file_path;
+    const char *data;
+    size_t size;
+    std::vector<char> owned; // file contents when it cannot be mapped
+    bool mapped;
+    int term_count;
+    int record_count;
+    uint64_t table_offset;
+    uint64_t pool_offset;
+
+    std::string_view termAt(int index) const;
+    int findTerm(std::string_view term) const;
+
+public:
+    InvertedIndex(Logger &log);
+    ~InvertedIndex();
+
+    bool open(const std::string &path);
+    void close();
+
+    /**
+     * Split text into index terms: folded runs of letters and digits,
+     * at least two bytes long, cut at MAX_TERM_SIZE
+     */
+    static void tokenize(std::string_view text, std::vector<std::string> &out);
+
+    /**
+     * Ascending record IDs containing term (already a single index term)
+     */
+    bool lookup(std::string_view term, std::vector<int> &out) const;
+
+    /**
+     * Records matching every query term (match_all) or any of them
+     * Terms of the query are tokenized like the indexed text
+     * @return ascending record IDs
+     */
+    std::vector<int> query(const std::string &text, bool match_all) const;
+
+    int getTermCount() const { return term_count; }
+    int getRecordCount() const { return record_count; }
+    size_t getFileSize() const { return size; }
+
+    InvertedIndex(const InvertedIndex &) = delete;
+    InvertedIndex &operator=(const InvertedIndex &) = delete;
+};
+
+#endif // INVERTED_INDEX_HPP
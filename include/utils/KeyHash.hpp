@@ -0,0 +1,72 @@
+#ifndef KEY_HASH_HPP
+#define KEY_HASH_HPP
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * KeyHash: Hash functions mapping record IDs to hash file buckets
+ *
+ * Extendible hashing routes on the low bits of the hash, so they must
+ * depend on every bit of the key. Identity (the raw ID) only works for
+ * IDs spread evenly over their low bits; the mixers below do not care:
+ * - Murmur: MurmurHash3 32-bit finalizer
+ * - Xxh3: XXH3 avalanche of the ID times a 64-bit prime
+ * - Crc32c: CRC-32C of the ID bytes, with the SSE4.2 instruction when
+ *   the CPU has it
+ * Identity, Murmur (fmix32) and Crc32c are bijections on 32 bits; Xxh3
+ * truncates a 64-bit result and is not, so two IDs can share a hash.
+ * Buckets compare the stored IDs and never assume distinct hashes.
+ */
+class KeyHash
+{
+public:
+    enum class Function
+    {
+        Identity,
+        Murmur,
+        Xxh3,
+        Crc32c
+    };
+
+    static uint32_t hash(Function function, int key)
+    {
+        uint32_t h = static_cast<uint32_t>(key);
+        switch (function)
+        {
+        case Function::Murmur:
+            h ^= h >> 16;
+            h *= 0x85EBCA6BU;
+            h ^= h >> 13;
+            h *= 0xC2B2AE35U;
+            return h ^ (h >> 16);
+        case Function::Xxh3:
+        {
+            uint64_t x = h * 0x9E3779B185EBCA87ULL;
+            x ^= x >> 37;
+            x *= 0x165667919E3779F9ULL;
+            return static_cast<uint32_t>(x ^ (x >> 32));
+        }
+        case Function::Crc32c:
+            return crc32c(h);
+        default:
+            return h;
+        }
+    }
+
+    /**
+     * Function from its name: identity, murmur, xxh3 or crc32c
+     * @return false if the name is unknown
+     */
+    static bool parse(const std::string &name, Function &function);
+    static const char *name(Function function);
+
+    // CRC-32C of a byte range (page and log checksums)
+    static uint32_t crc32c(const char *data, size_t size);
+
+private:
+    static uint32_t crc32c(uint32_t key);
+};
+
+#endif // KEY_HASH_HPP
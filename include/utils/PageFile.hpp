@@ -0,0 +1,115 @@
+#ifndef PAGE_FILE_HPP
+#define PAGE_FILE_HPP
+
+#include <fstream>
+#include <string>
+#include <cstddef>
+#include "Logger.hpp"
+
+/**
+ * PageFile: Fixed-size page I/O over a single binary file
+ *
+ * Page N lives at byte offset N * page_size, so every page read or
+ * written is aligned to the block size configured in DBManager.
+ *
+ * A read-only file can also be memory-mapped: pages are then served
+ * straight from the OS page cache, without a read syscall or a copy.
+ */
+class PageFile
+{
+private:
+    Logger &logger;
+    std::string file_path;
+    std::fstream stream;
+    int page_size;
+    int page_count;
+    bool read_only;
+    int file_id;
+
+    // Read-only mapping of the whole file, nullptr when not mapped
+    char *mapping;
+    size_t mapping_size;
+
+    // Statistics
+    int pages_read;
+    int pages_written;
+
+public:
+    // Access pattern hint for a mapped file; WillNeed starts reading
+    // the pages in ahead of their use
+    enum class Access
+    {
+        Random,
+        Sequential,
+        WillNeed
+    };
+
+    PageFile(Logger &log, int pg_size = 4096);
+    ~PageFile();
+
+    /**
+     * Open the file at path
+     * @param create Truncate (or create) the file instead of opening it
+     * @param readonly Open for reading only (ignored when creating)
+     */
+    bool open(const std::string &path, bool create, bool readonly = false);
+
+    /**
+     * Close the file; its pages cached in the Buffer pool are written
+     * back and dropped first
+     */
+    void close();
+    void flush();
+
+    /**
+     * Flush and fsync the file, so every page written so far survives
+     * a crash
+     */
+    bool sync();
+
+    /**
+     * Map the (read-only) file into memory
+     * Fails, leaving the buffered path in place, for writable or empty
+     * files or when mmap is unavailable
+     */
+    bool map(Access access);
+    void advise(int first_page, int count, Access access);
+
+    /**
+     * Page bytes inside the mapping, valid until close
+     * @return nullptr if the file is not mapped or page_id is out of bounds
+     */
+    const char *mappedPage(int page_id);
+
+    bool readPage(int page_id, char *buffer);
+    bool writePage(int page_id, const char *buffer);
+
+    /**
+     * Reserve a new page id at the end of the file
+     * The page only exists on disk after its first writePage
+     */
+    int allocatePage() { return page_count++; }
+
+    /**
+     * Cut the file down to its first pages; cached frames of the pages
+     * cut off are dropped from the Buffer pool unwritten
+     */
+    bool truncate(int pages);
+
+    // Getters
+    bool isOpen() const { return stream.is_open(); }
+    bool isMapped() const { return mapping != nullptr; }
+    int getFileId() const { return file_id; }
+    int getPageSize() const { return page_size; }
+    int getPageCount() const { return page_count; }
+    int getPagesRead() const { return pages_read; }
+    int getPagesWritten() const { return pages_written; }
+    const std::string &getFilePath() const { return file_path; }
+
+    void setPageSize(int size) { page_size = size; }
+
+    PageFile(const PageFile &) = delete;
+    PageFile &operator=(const PageFile &) = delete;
+};
+
+#endif // PAGE_FILE_HPP
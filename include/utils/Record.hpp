@@ -160,14 +160,15 @@ public:
             std::memcpy(&field_sz, buffer + offset, 4);
             offset += 4;
 
-            if (field_sz > 0 && offset + field_sz <= buffer_size)
-            {
-                RecordField field;
-                field.field_size = field_sz;
-                field.field_data.assign(buffer + offset, buffer + offset + field_sz);
-                rec.fields.push_back(field);
-                offset += field_sz;
-            }
+            if (field_sz < 0 || offset + field_sz > buffer_size)
+                break;
+
+            // Empty fields are kept so field indexes match the schema
+            RecordField field;
+            field.field_size = field_sz;
+            field.field_data.assign(buffer + offset, buffer + offset + field_sz);
+            rec.fields.push_back(field);
+            offset += field_sz;
         }
 
         return rec;
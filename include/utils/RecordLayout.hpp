@@ -0,0 +1,121 @@
+#ifndef RECORD_LAYOUT_HPP
+#define RECORD_LAYOUT_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include "SchemaParser.hpp"
+
+/**
+ * RecordLayout: Binary column encoding generated from the schema
+ *
+ * Record bytes:
+ * [ID: 4][Num Fields: 4][Total Size: 4]
+ * [Fixed columns]       <- INT/DATAH/ALFA in schema order, constant offsets
+ * [Var End: 2] x V      <- end offset of each VARALFA value
+ * [Var bytes]           <- VARALFA values back to back
+ *
+ * Column encodings:
+ * - INT      4 bytes, little-endian int32
+ * - DATAH    8 bytes, seconds since 1970-01-01 00:00:00 (UTC)
+ * - ALFA(n)  n bytes, zero padded
+ * - VARALFA  bytes cut at the declared maximum
+ *
+ * Every offset is known from the schema or read from the end table, so
+ * reaching any column is a single lookup instead of a walk over the
+ * columns before it.
+ *
+ * Empty or NULL INT/DATAH values are stored as the type's minimum and
+ * printed back as NULL.
+ */
+class RecordLayout
+{
+public:
+    enum class Type
+    {
+        Int,
+        DateTime,
+        Alfa,
+        VarAlfa
+    };
+
+    struct Column
+    {
+        std::string name;
+        Type type;
+        int width;  // encoded bytes, or the maximum length for VARALFA
+        int offset; // value offset, or offset of its end entry for VARALFA
+    };
+
+    static const int HEADER_SIZE = 12;
+    static const int32_t NULL_INT = INT32_MIN;
+    static const int64_t NULL_DATETIME = INT64_MIN;
+
+private:
+    std::vector<Column> columns;
+    int var_table;  // offset of the VARALFA end table
+    int var_data;   // offset of the first VARALFA value
+
+    static int readOffset(const char *ptr)
+    {
+        uint16_t value = 0;
+        std::memcpy(&value, ptr, 2);
+        return value;
+    }
+
+public:
+    RecordLayout() : var_table(HEADER_SIZE), var_data(HEADER_SIZE) {}
+    explicit RecordLayout(const std::vector<FieldSpec> &schema);
+
+    int getColumnCount() const { return static_cast<int>(columns.size()); }
+    const Column &getColumn(int index) const { return columns[index]; }
+    int findColumn(const std::string &name) const;
+
+    /**
+     * Encode one CSV row (one token per column) and append it to out
+     * The first column is the record ID and must be a valid INT
+     * @return false, with the reason in error, if a value does not parse
+     */
+    bool encode(const std::vector<std::string_view> &tokens, std::vector<char> &out,
+                std::string &error) const;
+
+    /**
+     * Check that a stored record matches the layout and its variable
+     * column offsets stay inside size
+     */
+    bool validate(const char *record, int size) const;
+
+    /**
+     * Value bytes of a column of a validated record, O(1)
+     * ALFA padding is not part of the value
+     */
+    std::string_view field(const char *record, int column) const
+    {
+        const Column &c = columns[column];
+        if (c.type != Type::VarAlfa)
+        {
+            std::string_view value(record + c.offset, c.width);
+            if (c.type == Type::Alfa)
+            {
+                size_t used = value.find('\0');
+                if (used != std::string_view::npos)
+                    value = value.substr(0, used);
+            }
+            return value;
+        }
+        int begin = c.offset == var_table ? var_data : readOffset(record + c.offset - 2);
+        return std::string_view(record + begin, readOffset(record + c.offset) - begin);
+    }
+
+    /**
+     * Column value as text, the way it appeared in the CSV
+     */
+    std::string format(int column, std::string_view bytes) const;
+
+    static bool parseDateTime(std::string_view text, int64_t &epoch);
+    static std::string formatDateTime(int64_t epoch);
+};
+
+#endif // RECORD_LAYOUT_HPP
@@ -0,0 +1,113 @@
+#ifndef RECORD_VIEW_HPP
+#define RECORD_VIEW_HPP
+
+#include <string>
+#include <string_view>
+#include <cstring>
+#include "RecordLayout.hpp"
+
+/**
+ * RecordView: Non-owning view of a stored record
+ *
+ * Reads the RecordLayout encoding in place. The record is checked once
+ * when the view is set; after that every column is reached through the
+ * layout's fixed offsets or its end table, so access is O(1) and nothing
+ * is copied or allocated. Without a layout only the ID is readable. The
+ * view is only valid while the underlying page buffer is.
+ */
+class RecordView
+{
+    const RecordLayout *layout;
+    const char *data;
+    int size;
+    int num_fields;
+
+    static int readInt(const char *ptr)
+    {
+        int value = 0;
+        std::memcpy(&value, ptr, 4);
+        return value;
+    }
+
+public:
+    RecordView() : layout(nullptr), data(nullptr), size(0), num_fields(0) {}
+    explicit RecordView(const RecordLayout &record_layout)
+        : layout(&record_layout), data(nullptr), size(0), num_fields(0) {}
+
+    RecordView(const char *buffer, int buffer_size, const RecordLayout &record_layout)
+        : layout(&record_layout)
+    {
+        reset(buffer, buffer_size);
+    }
+
+    /**
+     * Point the view at a stored record
+     * A record that does not match the layout exposes no fields
+     */
+    void reset(const char *buffer, int buffer_size)
+    {
+        data = nullptr;
+        size = 0;
+        num_fields = 0;
+        if (!buffer || buffer_size < RecordLayout::HEADER_SIZE)
+            return;
+
+        data = buffer;
+        size = buffer_size;
+        if (layout && layout->validate(buffer, buffer_size))
+        {
+            num_fields = layout->getColumnCount();
+        }
+    }
+
+    bool isValid() const { return data != nullptr; }
+    int getId() const { return data ? readInt(data) : 0; }
+    int getTotalSize() const { return size; }
+    int getNumFields() const { return num_fields; }
+    const char *getData() const { return data; }
+
+    /**
+     * Encoded value bytes (text for ALFA/VARALFA), empty for an out of
+     * range index
+     */
+    std::string_view getField(int index) const
+    {
+        if (index < 0 || index >= num_fields)
+            return std::string_view();
+        return layout->field(data, index);
+    }
+
+    /**
+     * Value of an INT column, RecordLayout::NULL_INT if missing
+     */
+    int32_t getInt(int index) const
+    {
+        int32_t value = RecordLayout::NULL_INT;
+        std::string_view bytes = getField(index);
+        if (bytes.size() == 4)
+            std::memcpy(&value, bytes.data(), 4);
+        return value;
+    }
+
+    /**
+     * Value of a DATAH column in epoch seconds, RecordLayout::NULL_DATETIME if missing
+     */
+    int64_t getDateTime(int index) const
+    {
+        int64_t value = RecordLayout::NULL_DATETIME;
+        std::string_view bytes = getField(index);
+        if (bytes.size() == 8)
+            std::memcpy(&value, bytes.data(), 8);
+        return value;
+    }
+
+    /**
+     * Column value as text (allocates)
+     */
+    std::string getFieldAsString(int index) const
+    {
+        return layout ? layout->format(index, getField(index)) : std::string();
+    }
+};
+
+#endif // RECORD_VIEW_HPP
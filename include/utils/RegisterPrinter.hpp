@@ -0,0 +1,29 @@
+#ifndef REGISTER_PRINTER_HPP
+#define REGISTER_PRINTER_HPP
+
+#include <iostream>
+#include <vector>
+#include "RecordView.hpp"
+#include "SchemaParser.hpp"
+
+/**
+ * Print a stored record using the schema field names
+ * Records on disk do not carry names, so they come from the schema;
+ * typed columns are formatted back to their CSV text
+ */
+inline void printRegister(std::ostream &out, const RecordView &rec,
+                          const std::vector<FieldSpec> &schema)
+{
+    out << "Record ID: " << rec.getId() << " (" << rec.getTotalSize() << " bytes)\n";
+    for (int i = 0; i < rec.getNumFields(); ++i)
+    {
+        out << "  ";
+        if (i < static_cast<int>(schema.size()))
+            out << schema[i].name;
+        else
+            out << "Field " << i;
+        out << ": " << rec.getFieldAsString(i) << "\n";
+    }
+}
+
+#endif // REGISTER_PRINTER_HPP
@@ -10,6 +10,7 @@
 #include <iostream>
 #include <regex>
 #include <algorithm>
+#include <cstdlib>
 #include "Logger.hpp"
 
 struct FieldSpec
@@ -56,8 +57,18 @@ public:
         int max_records_per_block;
         int record_size;
         double load_factor;
+        double index_fill_factor;
         int initial_buckets;
+        int max_global_depth;
+        int buffer_frames;
+        bool use_mmap;
+        int loader_threads;
+        int group_size;
+        std::string split_policy;
+        std::string hash_function;
         std::string table_name;
+        std::string data_dir;
+        std::string schema_path;
     };
 
 private:
@@ -74,12 +85,80 @@ public:
         config.block_size = 4096;
         config.page_size = 4096;
         config.load_factor = 0.7;
+        config.index_fill_factor = 0.9;
+        config.initial_buckets = 16;
+        config.max_global_depth = 20;
+        config.buffer_frames = 1024;
+        config.use_mmap = true;
+        config.loader_threads = 0;
+        config.group_size = 1024;
+        config.split_policy = "load";
+        config.hash_function = "murmur";
+        config.record_size = 0;
+        config.max_records_per_block = 0;
+
+        const char *data_dir = std::getenv("DATA_DIR");
+        config.data_dir = data_dir ? data_dir : "data/db";
+
+        const char *schema_path = std::getenv("SCHEMA_PATH");
+        config.schema_path = schema_path ? schema_path : "schema.almdb";
+
+        const char *buffer_frames = std::getenv("BUFFER_FRAMES");
+        if (buffer_frames && std::atoi(buffer_frames) > 0)
+        {
+            config.buffer_frames = std::atoi(buffer_frames);
+        }
+
+        // USE_MMAP=0 reads the CSV and serves lookups through the buffer pool instead
+        const char *use_mmap = std::getenv("USE_MMAP");
+        if (use_mmap && std::string(use_mmap) == "0")
+        {
+            config.use_mmap = false;
+        }
+
+        // Parser threads used by upload, 0 = one per hardware thread
+        const char *loader_threads = std::getenv("LOADER_THREADS");
+        if (loader_threads && std::atoi(loader_threads) > 0)
+        {
+            config.loader_threads = std::atoi(loader_threads);
+        }
+
+        // Hash file inserts/removes per write-ahead log group commit, 0 = no log
+        const char *group_size = std::getenv("GROUP_COMMIT");
+        if (group_size && *group_size && std::atoi(group_size) >= 0)
+        {
+            config.group_size = std::atoi(group_size);
+        }
+
+        // Hash directory depth past which full buckets chain overflow pages
+        const char *max_depth = std::getenv("HASH_MAX_DEPTH");
+        if (max_depth && std::atoi(max_depth) > 0)
+        {
+            config.max_global_depth = std::atoi(max_depth);
+        }
+
+        // When upload splits hash buckets: overflow, load or hybrid
+        const char *split_policy = std::getenv("SPLIT_POLICY");
+        if (split_policy && *split_policy)
+        {
+            config.split_policy = split_policy;
+        }
+
+        // Hash of the IDs for new hash files: identity, murmur, xxh3 or crc32c
+        const char *hash_function = std::getenv("HASH_FUNCTION");
+        if (hash_function && *hash_function)
+        {
+            config.hash_function = hash_function;
+        }
     }
 
     void initializeFromSchema(const std::vector<FieldSpec> &schema_fields,
                               const std::string &table_name);
     const DBConfig &getConfig() const { return config; }
+    std::string getFilePath(const std::string &name) const { return config.data_dir + "/" + name; }
     void printConfig() const;
     void setBlockSize(int size);
     void setPageSize(int size);
-};
\ No newline at end of file
+};
+
+#endif // SCHEMA_PARSER_HPP
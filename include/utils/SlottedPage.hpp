@@ -0,0 +1,73 @@
+#ifndef SLOTTED_PAGE_HPP
+#define SLOTTED_PAGE_HPP
+
+/**
+ * SlottedPage: Variable-length record page (non-owning view over a block)
+ *
+ * [Slot Count: 4][Free End: 4][Live Records: 4][Live Bytes: 4][Aux: 4][Next: 4]
+ * [Slot 0: Offset 4, Length 4][Slot 1]...  -> grows forward
+ * ... free space ...
+ * [Record bytes]                            <- grows back from the page end
+ *
+ * Slot k gives the k-th record in O(1). A deleted record leaves an
+ * empty slot (length 0) that later inserts reuse, so slot numbers stay
+ * stable; compact() squeezes the holes out of the record area.
+ * Aux is owner-defined (hash buckets keep their local depth there).
+ * Next links a page to another of the same file, -1 for none (hash
+ * buckets chain their overflow pages through it).
+ */
+class SlottedPage
+{
+private:
+    char *data;
+    int page_size;
+
+    int readField(int offset) const;
+    void writeField(int offset, int value);
+    int slotOffset(int slot) const { return HEADER_SIZE + slot * SLOT_SIZE; }
+
+public:
+    static const int HEADER_SIZE = 24;
+    static const int SLOT_SIZE = 8;
+
+    SlottedPage(char *page, int size) : data(page), page_size(size) {}
+
+    /**
+     * Initialize an empty page
+     */
+    static void format(char *page, int size, int aux = 0);
+
+    /**
+     * Store a record, reusing an empty slot when there is one
+     * Compacts the page if the bytes only fit after removing holes
+     * @return slot number, or -1 when the record does not fit
+     */
+    int insert(const char *record, int length);
+
+    /**
+     * Record bytes of a slot (nullptr for empty or invalid slots)
+     */
+    const char *get(int slot, int &length) const;
+
+    bool remove(int slot);
+    void compact();
+
+    // Bytes an insert of a new record could still use (slot included)
+    int getFreeSpace() const;
+    int getContiguousFree() const;
+
+    int getSlotCount() const { return readField(0); }
+    int getLiveRecords() const { return readField(8); }
+    int getLiveBytes() const { return readField(12); }
+    int getAux() const { return readField(16); }
+    void setAux(int value) { writeField(16, value); }
+    int getNext() const { return readField(20); }
+    void setNext(int page_id) { writeField(20, page_id); }
+
+    /**
+     * Space a record takes in a page, slot entry included
+     */
+    static int footprint(int length) { return length + SLOT_SIZE; }
+};
+
+#endif // SLOTTED_PAGE_HPP
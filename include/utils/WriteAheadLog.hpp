@@ -0,0 +1,108 @@
+#ifndef WRITE_AHEAD_LOG_HPP
+#define WRITE_AHEAD_LOG_HPP
+
+#include <string>
+#include <vector>
+#include <functional>
+#include "Logger.hpp"
+
+/**
+ * WriteAheadLog: Redo log of page after-images for one page file
+ *
+ * Record: [CRC][Type][LSN (8 bytes)][Page ID][Length] + Length bytes
+ * - PAGE: the whole page as it is after the change
+ * - COMMIT: closes a group; the payload holds the other changes of the
+ *   group (opaque to the log)
+ * The CRC (CRC-32C) covers the record after its own field. LSNs keep
+ * growing across truncations and reopens, so the owner can record the
+ * last group its own files reflect and replay skips up to it.
+ *
+ * Records of a group are buffered in memory and reach the file with one
+ * write and one fdatasync on commit (group commit); a group that fails
+ * to reach the file is cut off it again. Replay stops at the
+ * first truncated or corrupt record and only applies pages of groups
+ * whose commit record made it, so a torn group is dropped whole.
+ * Once a checkpoint has the pages and metadata in their own files the
+ * log is truncated.
+ */
+class WriteAheadLog
+{
+public:
+    enum RecordType
+    {
+        PAGE = 1,
+        COMMIT = 2
+    };
+
+    static const int RECORD_HEADER = 24;
+
+private:
+    Logger &logger;
+    std::string log_path;
+    int fd;
+    long long next_lsn;
+    // Bytes in the log file since it was opened or truncated
+    long long log_size;
+
+    // Records of the open group
+    std::vector<char> pending;
+
+    // Statistics
+    long commits;
+    long pages_logged;
+    long long bytes_logged;
+
+    void append(RecordType type, int page_id, const char *data, int size);
+    // Drop the open group and cut what reached the file of it
+    bool discardGroup();
+
+public:
+    explicit WriteAheadLog(Logger &log);
+    ~WriteAheadLog();
+
+    /**
+     * Open the log at path empty; anything it held must have been
+     * replayed already
+     * @param first_lsn LSN of the first record written
+     */
+    bool open(const std::string &path, long long first_lsn);
+    void close();
+
+    // Add a page image to the open group
+    void logPage(int page_id, const char *data, int size);
+
+    /**
+     * Close the open group with its other changes and make it durable
+     * @return false if the group could not be written or synced; the
+     *         group is dropped and the file keeps only earlier groups
+     */
+    bool commit(const std::string &changes);
+
+    // Drop every record, after a checkpoint
+    bool truncate();
+
+    /**
+     * Replay the committed groups of the log at path, in order
+     * @param after_lsn Groups whose commit LSN is not above it are skipped
+     * @param apply_page Gets every page image of a replayed group
+     * @param apply_commit Gets the commit record of a replayed group,
+     *        after its pages; false from either aborts
+     * @return Number of groups replayed, -1 if a callback failed
+     */
+    static int replay(Logger &log, const std::string &path, long long after_lsn,
+                      const std::function<bool(int page_id, const char *data, int size)> &apply_page,
+                      const std::function<bool(long long lsn, const char *data, int size)> &apply_commit);
+
+    bool isOpen() const { return fd >= 0; }
+    // LSN of the last record written, the commit of the last group
+    long long getLastLsn() const { return next_lsn - 1; }
+    long long getSize() const { return log_size; }
+    long getCommits() const { return commits; }
+    long getPagesLogged() const { return pages_logged; }
+    long long getBytesLogged() const { return bytes_logged; }
+
+    WriteAheadLog(const WriteAheadLog &) = delete;
+    WriteAheadLog &operator=(const WriteAheadLog &) = delete;
+};
+
+#endif // WRITE_AHEAD_LOG_HPP
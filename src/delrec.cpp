@@ -0,0 +1,98 @@
+#include "SchemaParser.hpp"
+#include "ExtendibleHash.hpp"
+#include "Buffer.hpp"
+#include "Chronometer.hpp"
+#include <iostream>
+
+namespace
+{
+    bool parseId(const std::string &text, int &id)
+    {
+        try
+        {
+            size_t used = 0;
+            id = std::stoi(text, &used);
+            return used == text.size();
+        }
+        catch (const std::exception &e)
+        {
+            return false;
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    Logger *logger = Logger::getLogger();
+    if (argc < 2)
+    {
+        LOG_ERROR(logger, "No ID given. The command should follow the struct delrec ${ID} [${ID}...] or delrec --recover");
+        return 1;
+    }
+
+    // --recover alone only opens the hash file read-write, which replays
+    // its write-ahead log after a crash
+    std::vector<int> ids;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::string(argv[i]) == "--recover")
+        {
+            continue;
+        }
+        int id = 0;
+        if (!parseId(argv[i], id))
+        {
+            LOG_ERROR(logger, "Invalid ID: " + std::string(argv[i]));
+            return 1;
+        }
+        ids.push_back(id);
+    }
+
+    Chronometer chrono(*logger);
+    chrono.start();
+
+    DBManager db_manager(*logger);
+    Buffer::getBuffer()->configure(db_manager.getConfig().buffer_frames,
+                                   db_manager.getConfig().block_size);
+
+    ExtendibleHash hash(*logger);
+    hash.setGroupSize(db_manager.getConfig().group_size);
+    if (!hash.open(db_manager.getFilePath("artigo"), false))
+    {
+        LOG_ERROR(logger, hash.needsRecovery() ? "Replaying the write-ahead log of the hash file failed"
+                                               : "Hash file not found. Run upload first");
+        return 1;
+    }
+
+    int removed = 0;
+    for (int id : ids)
+    {
+        if (hash.remove(id))
+        {
+            removed++;
+        }
+        else if (!hash.hasFailed())
+        {
+            std::cout << "Record " << id << " not found\n";
+        }
+    }
+    int depth = hash.getGlobalDepth();
+    int buckets = hash.getTotalBuckets();
+    int merges = hash.getMergesPerformed();
+    hash.close();
+    chrono.stop();
+    if (hash.hasFailed())
+    {
+        LOG_ERROR(logger, "Removing records failed");
+        return 1;
+    }
+
+    // The ID and title indexes keep the entries; lookups through them
+    // skip records that no longer exist
+    std::cout << "Removed: " << removed << " of " << ids.size() << "\n"
+              << "Buckets merged: " << merges << " Total buckets: " << buckets
+              << " Global depth: " << depth << "\n";
+    chrono.print("delrec");
+
+    return removed == static_cast<int>(ids.size()) ? 0 : 2;
+}
@@ -1,19 +1,174 @@
+#include "SchemaParser.hpp"
+#include "ExtendibleHash.hpp"
+#include "Buffer.hpp"
+#include "Chronometer.hpp"
+#include "RegisterPrinter.hpp"
+#include <iostream>
+#include <fstream>
 
+namespace
+{
+    // Keys looked up per batch; bounds memory and lets output stream
+    const size_t BATCH_KEYS = 16384;
 
+    bool parseId(const std::string &text, int &id)
+    {
+        try
+        {
+            size_t used = 0;
+            id = std::stoi(text, &used);
+            return used == text.size();
+        }
+        catch (const std::exception &e)
+        {
+            return false;
+        }
+    }
+
+    /**
+     * Look up one batch of keys in page order and print them in input order
+     * @return number of keys found
+     */
+    int runBatch(ExtendibleHash &hash, const RecordLayout &layout,
+                 const std::vector<int> &ids, const std::vector<FieldSpec> &schema)
+    {
+        std::vector<std::vector<char>> results(ids.size());
+        std::vector<bool> found(ids.size(), false);
+        RecordView rec(layout);
+        hash.searchBatch(ids, rec, [&](size_t index, bool hit)
+                         {
+                             if (hit)
+                             {
+                                 found[index] = true;
+                                 results[index].assign(rec.getData(), rec.getData() + rec.getTotalSize());
+                             }
+                         });
 
+        int count = 0;
+        for (size_t i = 0; i < ids.size(); ++i)
+        {
+            if (found[i])
+            {
+                RecordView view(results[i].data(), static_cast<int>(results[i].size()), layout);
+                printRegister(std::cout, view, schema);
+                count++;
+            }
+            else
+            {
+                std::cout << "Record " << ids[i] << " not found\n";
+            }
+        }
+        return count;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    Logger *logger = Logger::getLogger();
+    bool batch = argc >= 2 && std::string(argv[1]) == "--batch";
+    if ((!batch && argc != 2) || (batch && argc > 3))
+    {
+        LOG_ERROR(logger, "No ID given. The command should follow the struct findrec ${ID} "
+                          "or findrec --batch [file] (IDs one per line, stdin by default)");
+        return 1;
+    }
 
-int main(int argc, char** argv){
-    if (argc != 2){
-        LOG_ERROR("No files given. The command should follow the struct findrec ${ID}");
+    int id = 0;
+    if (!batch && !parseId(argv[1], id))
+    {
+        LOG_ERROR(logger, "Invalid ID: " + std::string(argv[1]));
         return 1;
     }
-    Logger logger = getLogger();
-    Chronometer chrono(logger);
+
+    std::ifstream id_file;
+    if (batch && argc == 3 && std::string(argv[2]) != "-")
+    {
+        id_file.open(argv[2]);
+        if (!id_file)
+        {
+            LOG_ERROR(logger, "Could not open ID file: " + std::string(argv[2]));
+            return 1;
+        }
+    }
+    std::istream &input = id_file.is_open() ? static_cast<std::istream &>(id_file) : std::cin;
+
+    Chronometer chrono(*logger);
     chrono.start();
 
+    DBManager db_manager(*logger);
+    SchemaParser parser(*logger);
+    if (!parser.parseSchema(db_manager.getConfig().schema_path))
+    {
+        LOG_ERROR(logger, "Failed to parse schema");
+        return 1;
+    }
+    Buffer::getBuffer()->configure(db_manager.getConfig().buffer_frames,
+                                   db_manager.getConfig().block_size);
+
+    ExtendibleHash hash(*logger);
+    if (!hash.open(db_manager.getFilePath("artigo"), true, db_manager.getConfig().use_mmap))
+    {
+        LOG_ERROR(logger, hash.needsRecovery() ? "Hash file log not replayed. Run delrec --recover first"
+                                               : "Hash file not found. Run upload first");
+        return 1;
+    }
+
+    RecordLayout layout(parser.getFields());
 
+    if (batch)
+    {
+        // The file is opened and the directory loaded once for all keys
+        int keys = 0;
+        int found = 0;
+        int line_number = 0;
+        std::vector<int> ids;
+        std::string line;
+        while (std::getline(input, line))
+        {
+            line_number++;
+            size_t begin = line.find_first_not_of(" \t\r");
+            if (begin == std::string::npos)
+                continue;
+            size_t end = line.find_last_not_of(" \t\r");
+            if (!parseId(line.substr(begin, end - begin + 1), id))
+            {
+                LOG_WARN(logger, "Line " + std::to_string(line_number) + ": invalid ID \"" + line + "\"");
+                continue;
+            }
+            ids.push_back(id);
+            if (ids.size() == BATCH_KEYS)
+            {
+                keys += ids.size();
+                found += runBatch(hash, layout, ids, parser.getFields());
+                ids.clear();
+            }
+        }
+        keys += ids.size();
+        found += runBatch(hash, layout, ids, parser.getFields());
+        chrono.stop();
 
+        std::cout << "Keys: " << keys << " Found: " << found << "\n"
+                  << "Blocks read: " << hash.getBlocksRead()
+                  << " Total blocks: " << hash.getTotalBuckets() << "\n";
+        chrono.print("findrec");
+        return found == keys ? 0 : 2;
+    }
+
+    RecordView rec(layout);
+    bool found = hash.search(id, rec);
+    chrono.stop();
+
+    if (found)
+    {
+        printRegister(std::cout, rec, parser.getFields());
+    }
+    else
+    {
+        std::cout << "Record " << id << " not found\n";
+    }
+    std::cout << "Blocks read: " << hash.getBlocksRead()
+              << " Total blocks: " << hash.getTotalBuckets() << "\n";
+    chrono.print("findrec");
 
-    chrono.end();
-    return 0;
-}
\ No newline at end of file
+    return found ? 0 : 2;
+}
@@ -0,0 +1,95 @@
+#include "SchemaParser.hpp"
+#include "ExtendibleHash.hpp"
+#include "Buffer.hpp"
+#include "InvertedIndex.hpp"
+#include "Chronometer.hpp"
+#include "RegisterPrinter.hpp"
+#include <iostream>
+
+int main(int argc, char **argv)
+{
+    Logger *logger = Logger::getLogger();
+
+    // --or: records with any of the terms (default: all of them)
+    // --ids: print only the matching IDs
+    bool match_all = true;
+    bool ids_only = false;
+    int arg = 1;
+    for (; arg < argc; ++arg)
+    {
+        std::string option = argv[arg];
+        if (option == "--or")
+            match_all = false;
+        else if (option == "--ids")
+            ids_only = true;
+        else
+            break;
+    }
+    if (arg >= argc)
+    {
+        LOG_ERROR(logger, "No terms given. The command should follow the struct "
+                          "ftsearch [--or] [--ids] term...");
+        return 1;
+    }
+    std::string text;
+    for (; arg < argc; ++arg)
+    {
+        text += argv[arg];
+        text += ' ';
+    }
+
+    Chronometer chrono(*logger);
+    chrono.start();
+
+    DBManager db_manager(*logger);
+    SchemaParser parser(*logger);
+    if (!parser.parseSchema(db_manager.getConfig().schema_path))
+    {
+        LOG_ERROR(logger, "Failed to parse schema");
+        return 1;
+    }
+    Buffer::getBuffer()->configure(db_manager.getConfig().buffer_frames,
+                                   db_manager.getConfig().block_size);
+
+    InvertedIndex index(*logger);
+    if (!index.open(db_manager.getFilePath("artigo_texto.fts")))
+    {
+        LOG_ERROR(logger, "Full-text index not found. Run upload first");
+        return 1;
+    }
+
+    std::vector<int> matches = index.query(text, match_all);
+    chrono.stop();
+
+    if (ids_only)
+    {
+        for (int id : matches)
+        {
+            std::cout << id << "\n";
+        }
+    }
+    else if (!matches.empty())
+    {
+        ExtendibleHash hash(*logger);
+        if (!hash.open(db_manager.getFilePath("artigo"), true, db_manager.getConfig().use_mmap))
+        {
+            LOG_ERROR(logger, hash.needsRecovery() ? "Hash file log not replayed. Run delrec --recover first"
+                                                   : "Hash file not found. Run upload first");
+            return 1;
+        }
+        // Records come out in hash file order, each page read once
+        RecordLayout layout(parser.getFields());
+        RecordView rec(layout);
+        hash.searchBatch(matches, rec, [&](size_t, bool found)
+                         {
+                             if (found)
+                                 printRegister(std::cout, rec, parser.getFields());
+                         });
+    }
+
+    std::cout << "Matches: " << matches.size()
+              << " Terms in index: " << index.getTermCount() << "\n";
+    chrono.print("ftsearch");
+
+    return matches.empty() ? 2 : 0;
+}
@@ -0,0 +1,144 @@
+#include "SchemaParser.hpp"
+#include "ExtendibleHash.hpp"
+#include "Buffer.hpp"
+#include "BTreeP.hpp"
+#include "Chronometer.hpp"
+#include "RegisterPrinter.hpp"
+#include <iostream>
+
+namespace
+{
+    // Data pages requested ahead while printing a range
+    const size_t RANGE_WINDOW = 256;
+
+    bool parseId(const std::string &text, int &id)
+    {
+        try
+        {
+            size_t used = 0;
+            id = std::stoi(text, &used);
+            return used == text.size();
+        }
+        catch (const std::exception &e)
+        {
+            return false;
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    Logger *logger = Logger::getLogger();
+    bool range = argc >= 2 && std::string(argv[1]) == "--range";
+    if ((!range && argc != 2) || (range && argc != 4))
+    {
+        LOG_ERROR(logger, "No ID given. The command should follow the struct seek1 ${ID} "
+                          "or seek1 --range ${FROM} ${TO}");
+        return 1;
+    }
+
+    int id = 0;
+    int high = 0;
+    const char *invalid = nullptr;
+    if (!parseId(argv[range ? 2 : 1], id))
+        invalid = argv[range ? 2 : 1];
+    else if (range && !parseId(argv[3], high))
+        invalid = argv[3];
+    if (invalid)
+    {
+        LOG_ERROR(logger, "Invalid ID: " + std::string(invalid));
+        return 1;
+    }
+
+    Chronometer chrono(*logger);
+    chrono.start();
+
+    DBManager db_manager(*logger);
+    SchemaParser parser(*logger);
+    if (!parser.parseSchema(db_manager.getConfig().schema_path))
+    {
+        LOG_ERROR(logger, "Failed to parse schema");
+        return 1;
+    }
+    Buffer::getBuffer()->configure(db_manager.getConfig().buffer_frames,
+                                   db_manager.getConfig().block_size);
+
+    BTreeP index(*logger);
+    ExtendibleHash hash(*logger);
+    bool mapped = db_manager.getConfig().use_mmap;
+    if (!index.open(db_manager.getFilePath("artigo_id.idx"), true, mapped) ||
+        !hash.open(db_manager.getFilePath("artigo"), true, mapped))
+    {
+        LOG_ERROR(logger, hash.needsRecovery() ? "Hash file log not replayed. Run delrec --recover first"
+                                               : "Index or data file not found. Run upload first");
+        return 1;
+    }
+
+    RecordLayout layout(parser.getFields());
+    RecordView rec(layout);
+
+    if (range)
+    {
+        // Index entries are buffered a window at a time so their data
+        // pages can be requested before the records are printed
+        int printed = 0;
+        std::vector<std::pair<int, int>> window;
+        auto flush = [&]()
+        {
+            for (const auto &entry : window)
+            {
+                hash.prefetch(entry.second);
+            }
+            for (const auto &entry : window)
+            {
+                // A bucket merge may have moved the record since the index was built
+                if (hash.fetch(entry.second, entry.first, rec) || hash.search(entry.first, rec))
+                {
+                    printRegister(std::cout, rec, parser.getFields());
+                    printed++;
+                }
+            }
+            window.clear();
+        };
+        index.rangeScan(id, high, [&](int key, int value)
+                        {
+                            window.emplace_back(key, value);
+                            if (window.size() == RANGE_WINDOW)
+                                flush();
+                            return true;
+                        });
+        flush();
+        chrono.stop();
+
+        if (printed == 0)
+        {
+            std::cout << "No record with ID between " << id << " and " << high << "\n";
+        }
+        std::cout << "Records: " << printed << "\n"
+                  << "Index blocks read: " << index.getBlocksRead()
+                  << " Total index blocks: " << index.getTotalBlocks() << "\n"
+                  << "Data blocks read: " << hash.getBlocksRead() << "\n";
+        chrono.print("seek1");
+        return printed ? 0 : 2;
+    }
+
+    int block_id = 0;
+    bool found = index.search(id, block_id) &&
+                 (hash.fetch(block_id, id, rec) || hash.search(id, rec));
+    chrono.stop();
+
+    if (found)
+    {
+        printRegister(std::cout, rec, parser.getFields());
+    }
+    else
+    {
+        std::cout << "Record " << id << " not found\n";
+    }
+    std::cout << "Index blocks read: " << index.getBlocksRead()
+              << " Total index blocks: " << index.getTotalBlocks() << "\n"
+              << "Data blocks read: " << hash.getBlocksRead() << "\n";
+    chrono.print("seek1");
+
+    return found ? 0 : 2;
+}
@@ -0,0 +1,98 @@
+#include "SchemaParser.hpp"
+#include "ExtendibleHash.hpp"
+#include "Buffer.hpp"
+#include "BTreePString.hpp"
+#include "Chronometer.hpp"
+#include "Collation.hpp"
+#include "RegisterPrinter.hpp"
+#include <iostream>
+
+int main(int argc, char **argv)
+{
+    Logger *logger = Logger::getLogger();
+
+    // --prefix: titles starting with the text
+    // --fold: ignore case and accents (uses the folded title index)
+    bool prefix = false;
+    bool fold = false;
+    int arg = 1;
+    for (; arg < argc - 1; ++arg)
+    {
+        std::string option = argv[arg];
+        if (option == "--prefix")
+            prefix = true;
+        else if (option == "--fold")
+            fold = true;
+        else
+            break;
+    }
+    if (arg != argc - 1)
+    {
+        LOG_ERROR(logger, "No title given. The command should follow the struct "
+                          "seek2 [--prefix] [--fold] \"${Titulo}\"");
+        return 1;
+    }
+    std::string title = argv[arg];
+
+    Chronometer chrono(*logger);
+    chrono.start();
+
+    DBManager db_manager(*logger);
+    SchemaParser parser(*logger);
+    if (!parser.parseSchema(db_manager.getConfig().schema_path))
+    {
+        LOG_ERROR(logger, "Failed to parse schema");
+        return 1;
+    }
+    Buffer::getBuffer()->configure(db_manager.getConfig().buffer_frames,
+                                   db_manager.getConfig().block_size);
+
+    BTreePString index(*logger);
+    ExtendibleHash hash(*logger);
+    bool mapped = db_manager.getConfig().use_mmap;
+    std::string index_name = fold ? "artigo_titulo_fold.idx" : "artigo_titulo.idx";
+    if (!index.open(db_manager.getFilePath(index_name), mapped) ||
+        !hash.open(db_manager.getFilePath("artigo"), true, mapped))
+    {
+        LOG_ERROR(logger, hash.needsRecovery() ? "Hash file log not replayed. Run delrec --recover first"
+                                               : "Index or data file not found. Run upload first");
+        return 1;
+    }
+
+    std::vector<RecordLocation> locations;
+    std::string key = fold ? Collation::fold(title) : title;
+    if (prefix)
+        index.searchPrefix(key, locations);
+    else
+        index.search(key, locations);
+
+    // Views are invalidated by the next fetch, keep owning copies
+    RecordLayout layout(parser.getFields());
+    std::vector<std::vector<char>> records;
+    for (const auto &loc : locations)
+    {
+        RecordView rec(layout);
+        // A bucket merge may have moved the record since the index was built
+        if (hash.fetch(loc.block_id, loc.record_id, rec) || hash.search(loc.record_id, rec))
+        {
+            records.emplace_back(rec.getData(), rec.getData() + rec.getTotalSize());
+        }
+    }
+    chrono.stop();
+
+    for (const auto &bytes : records)
+    {
+        RecordView rec(bytes.data(), static_cast<int>(bytes.size()), layout);
+        printRegister(std::cout, rec, parser.getFields());
+    }
+    if (records.empty())
+    {
+        std::cout << "No record with title \"" << title << "\"\n";
+    }
+    std::cout << "Index blocks read: " << index.getBlocksRead()
+              << " Total index blocks: " << index.getTotalBlocks() << "\n"
+              << "Data blocks read: " << hash.getBlocksRead() << "\n";
+    chrono.print("seek2");
+
+    return records.empty() ? 2 : 0;
+}
@@ -23,8 +23,8 @@ int main(int args, char**argv){
         LOG_INFO(logger,"Opening file: " + *reader->getFilePath());
 
         int line_count = 0;
-        while(reader->hasNextLine()){
-            std::vector<std::string> tokens = reader->line_processed();
+        std::vector<std::string_view> tokens;
+        while(reader->nextRow(tokens)){
 
             std::cout << "Line " << reader->getCurrentLine() << ": ";
             for (size_t i = 0; i < tokens.size(); ++i){
@@ -0,0 +1,229 @@
+#include "SchemaParser.hpp"
+#include "ExtendibleHash.hpp"
+#include "Buffer.hpp"
+#include "BTreeP.hpp"
+#include "BTreePString.hpp"
+#include "CsvPipeline.hpp"
+#include "CsvScanner.hpp"
+#include "Chronometer.hpp"
+#include "Collation.hpp"
+#include "InvertedIndex.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+
+int main(int argc, char *argv[])
+{
+    Logger *logger = Logger::getLogger();
+
+    // upload [--insert] ${CSV_PATH}
+    // --insert grows the hash one record at a time instead of bulk loading
+    bool bulk = true;
+    std::string csv_file;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--insert")
+            bulk = false;
+        else
+            csv_file = arg;
+    }
+
+    const char *env_csv = std::getenv("CSV_PATH");
+    if (csv_file.empty() && env_csv)
+    {
+        csv_file = env_csv;
+    }
+    if (csv_file.empty() || !std::filesystem::exists(csv_file))
+    {
+        LOG_ERROR(logger, "No file given. The command should follow the struct upload [--insert] ${CSV_PATH}");
+        return 1;
+    }
+
+    Chronometer total_time(*logger);
+    total_time.start();
+
+    DBManager db_manager(*logger);
+
+    // Parse schema
+    LOG_INFO(logger, "Step 1: Parsing schema from " + db_manager.getConfig().schema_path);
+    SchemaParser parser(*logger);
+    if (!parser.parseSchema(db_manager.getConfig().schema_path))
+    {
+        LOG_ERROR(logger, "Failed to parse schema");
+        return 1;
+    }
+    const auto &schema = parser.getFields();
+
+    db_manager.initializeFromSchema(schema, parser.getTableName());
+    db_manager.printConfig();
+    const auto &config = db_manager.getConfig();
+    Buffer::getBuffer()->configure(config.buffer_frames, config.block_size);
+
+    // Create the hash data file
+    LOG_INFO(logger, "Step 2: Creating hash file in " + config.data_dir);
+    std::filesystem::create_directories(config.data_dir);
+    ExtendibleHash hash(*logger, config.initial_buckets, config.block_size, config.load_factor);
+    hash.setMaxDepth(config.max_global_depth);
+    hash.setGroupSize(config.group_size);
+    KeyHash::Function hash_function;
+    if (KeyHash::parse(config.hash_function, hash_function))
+    {
+        hash.setHashFunction(hash_function);
+    }
+    else
+    {
+        LOG_WARN(logger, "Unknown hash function \"" + config.hash_function + "\", using murmur");
+    }
+    SplitPolicy split_policy;
+    if (ExtendibleHash::parseSplitPolicy(config.split_policy, split_policy))
+    {
+        hash.setSplitPolicy(split_policy);
+    }
+    else
+    {
+        LOG_WARN(logger, "Unknown split policy \"" + config.split_policy + "\", using load");
+    }
+    bool created = bulk
+                       ? hash.beginBulkLoad(db_manager.getFilePath("artigo"),
+                                            static_cast<long long>(std::filesystem::file_size(csv_file)))
+                       : hash.create(db_manager.getFilePath("artigo"));
+    if (!created)
+    {
+        LOG_ERROR(logger, "Failed to create hash file");
+        return 1;
+    }
+
+    // Read and insert records: parsing runs on the pipeline threads,
+    // hash writes stay on this one
+    CsvPipeline pipeline(*logger, schema, config.loader_threads, config.use_mmap);
+    LOG_INFO(logger, "Step 3: Reading CSV and inserting records into hash (" +
+                         std::to_string(pipeline.getParserThreads()) + " parser threads, " +
+                         CsvScanner::levelName(CsvScanner::detect()) + " scanner)");
+    bool loaded = pipeline.run(csv_file, [&](const char *bytes, int size)
+                               { return bulk ? hash.bulkAdd(bytes, size) : hash.insert(bytes, size); });
+    if (!loaded)
+    {
+        LOG_ERROR(logger, "Failed to read " + csv_file);
+        return 1;
+    }
+    int inserted_count = pipeline.getInserted();
+    int skipped_count = pipeline.getSkipped();
+
+    if (bulk && !hash.endBulkLoad())
+    {
+        LOG_ERROR(logger, "Bulk load failed");
+        return 1;
+    }
+    // The last group of --insert is made durable before the indexes are built
+    if (hash.hasFailed() || (!bulk && !hash.checkpoint()))
+    {
+        LOG_ERROR(logger, "Writing the hash file failed");
+        return 1;
+    }
+    LOG_INFO(logger, "Step 4: Hash file finalized");
+    hash.printStatistics();
+
+    // Every index is fed from one sequential scan of the hash file
+    RecordLayout layout(schema);
+    int title_field = layout.findColumn("Titulo");
+    if (title_field < 0)
+        title_field = 1;
+    int snippet_field = layout.findColumn("Snippet");
+    InvertedIndex::Builder text_index;
+
+    std::vector<std::pair<int, int>> id_entries;
+    std::vector<std::pair<std::string, RecordLocation>> title_entries;
+    id_entries.reserve(hash.getTotalRecords());
+    title_entries.reserve(hash.getTotalRecords());
+    hash.forEachRecord([&](int id, int block_id, const char *data, int size)
+                       {
+                           RecordView rec(data, size, layout);
+                           id_entries.emplace_back(id, block_id);
+                           title_entries.push_back({std::string(rec.getField(title_field)), {id, block_id}});
+                           text_index.add(id, rec.getField(title_field));
+                           text_index.add(id, rec.getField(snippet_field));
+                           text_index.countRecord();
+                       });
+
+    // Primary index: sorted (ID, data page) run
+    LOG_INFO(logger, "Step 5: Building primary B+ tree index on ID");
+    std::sort(id_entries.begin(), id_entries.end());
+
+    BTreeP primary_index(*logger, config.block_size);
+    if (!primary_index.bulkBuild(db_manager.getFilePath("artigo_id.idx"), id_entries,
+                                 config.index_fill_factor))
+    {
+        LOG_ERROR(logger, "Failed to build primary index");
+        return 1;
+    }
+    primary_index.close();
+
+    // Secondary index: (Titulo, location) run sorted by title
+    LOG_INFO(logger, "Step 6: Building secondary B+ tree index on Titulo");
+    std::stable_sort(title_entries.begin(), title_entries.end(),
+                     [](const std::pair<std::string, RecordLocation> &a,
+                        const std::pair<std::string, RecordLocation> &b)
+                     { return a.first < b.first; });
+
+    BTreePString title_index(*logger, config.block_size);
+    if (!title_index.bulkBuild(db_manager.getFilePath("artigo_titulo.idx"), title_entries,
+                               config.index_fill_factor))
+    {
+        LOG_ERROR(logger, "Failed to build secondary index");
+        return 1;
+    }
+    title_index.close();
+
+    // Folded title index for case and accent insensitive seek2 lookups,
+    // built from the same run with its keys folded and re-sorted
+    LOG_INFO(logger, "Step 7: Building folded B+ tree index on Titulo");
+    for (auto &entry : title_entries)
+    {
+        entry.first = Collation::fold(entry.first);
+    }
+    std::stable_sort(title_entries.begin(), title_entries.end(),
+                     [](const std::pair<std::string, RecordLocation> &a,
+                        const std::pair<std::string, RecordLocation> &b)
+                     { return a.first < b.first; });
+
+    BTreePString folded_index(*logger, config.block_size);
+    if (!folded_index.bulkBuild(db_manager.getFilePath("artigo_titulo_fold.idx"), title_entries,
+                                config.index_fill_factor))
+    {
+        LOG_ERROR(logger, "Failed to build folded title index");
+        return 1;
+    }
+    folded_index.close();
+
+    // Full-text index over Titulo and Snippet for ftsearch
+    LOG_INFO(logger, "Step 8: Building inverted index on Titulo and Snippet");
+    if (!text_index.write(*logger, db_manager.getFilePath("artigo_texto.fts")))
+    {
+        LOG_ERROR(logger, "Failed to build inverted index");
+        return 1;
+    }
+
+    hash.close();
+    total_time.stop();
+
+    std::ostringstream report;
+    report << "\n=== UPLOAD REPORT ===\n"
+           << "Total Records Inserted: " << inserted_count << "\n"
+           << "Records Skipped: " << skipped_count << "\n"
+           << "Blocks Read: " << hash.getBlocksRead() << "\n"
+           << "Blocks Written: " << hash.getBlocksWritten() << "\n"
+           << "Total Buckets: " << hash.getTotalBuckets() << "\n"
+           << "Hash Splits: " << hash.getSplitsPerformed()
+           << " (" << KeyHash::name(hash.getHashFunction()) << ")\n"
+           << "Primary Index Blocks: " << primary_index.getTotalBlocks()
+           << " (height " << primary_index.getHeight() << ")\n"
+           << "Secondary Index Blocks: " << title_index.getTotalBlocks()
+           << " (height " << title_index.getHeight() << ")\n"
+           << "Folded Title Index Blocks: " << folded_index.getTotalBlocks() << "\n"
+           << "Full-Text Index Terms: " << text_index.getTermCount() << "\n"
+           << "Total Execution Time: " << total_time.milliseconds() << " ms\n";
+    std::cout << report.str();
+
+    return 0;
+}
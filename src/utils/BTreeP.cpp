@@ -0,0 +1,414 @@
+#include "BTreeP.hpp"
+#include "Buffer.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    int readInt(const char *ptr)
+    {
+        int value = 0;
+        std::memcpy(&value, ptr, 4);
+        return value;
+    }
+
+    void writeInt(char *ptr, int value)
+    {
+        std::memcpy(ptr, &value, 4);
+    }
+
+    /**
+     * Split total items into groups of at most per_group, as evenly as
+     * possible, so the last node is not left nearly empty
+     */
+    std::vector<int> evenGroups(int total, int per_group)
+    {
+        int groups = std::max(1, (total + per_group - 1) / per_group);
+        std::vector<int> sizes(groups, total / groups);
+        for (int i = 0; i < total % groups; ++i)
+        {
+            sizes[i]++;
+        }
+        return sizes;
+    }
+}
+
+// ============== NODE LAYOUT ==============
+
+void BTreePNode::format(char *page, int page_size, int type)
+{
+    std::memset(page, 0, page_size);
+    writeInt(page, type);
+    writeInt(page + 8, NO_PAGE);
+}
+
+int BTreePNode::getType(const char *page) { return readInt(page); }
+int BTreePNode::getCount(const char *page) { return readInt(page + 4); }
+int BTreePNode::getNextLeaf(const char *page) { return readInt(page + 8); }
+void BTreePNode::setNextLeaf(char *page, int next) { writeInt(page + 8, next); }
+
+void BTreePNode::appendLeaf(char *page, int key, int value)
+{
+    int count = getCount(page);
+    char *slot = page + HEADER_SIZE + count * 8;
+    writeInt(slot, key);
+    writeInt(slot + 4, value);
+    writeInt(page + 4, count + 1);
+}
+
+int BTreePNode::getLeafKey(const char *page, int index)
+{
+    return readInt(page + HEADER_SIZE + index * 8);
+}
+
+int BTreePNode::getLeafValue(const char *page, int index)
+{
+    return readInt(page + HEADER_SIZE + index * 8 + 4);
+}
+
+void BTreePNode::setFirstChild(char *page, int child)
+{
+    writeInt(page + HEADER_SIZE, child);
+}
+
+void BTreePNode::appendInternal(char *page, int key, int child)
+{
+    int count = getCount(page);
+    char *slot = page + HEADER_SIZE + 4 + count * 8;
+    writeInt(slot, key);
+    writeInt(slot + 4, child);
+    writeInt(page + 4, count + 1);
+}
+
+int BTreePNode::findChild(const char *page, int key)
+{
+    // Binary search for the last separator <= key
+    int lo = 0, hi = getCount(page);
+    while (lo < hi)
+    {
+        int mid = (lo + hi) / 2;
+        if (readInt(page + HEADER_SIZE + 4 + mid * 8) <= key)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    // lo separators are <= key: child lo (child 0 is stored before the keys)
+    return lo == 0 ? readInt(page + HEADER_SIZE)
+                   : readInt(page + HEADER_SIZE + 4 + (lo - 1) * 8 + 4);
+}
+
+// ============== B+ TREE ==============
+
+BTreeP::BTreeP(Logger &log, int pg_size)
+    : logger(log), index_file(log, pg_size), page_size(pg_size),
+      root_page(BTreePNode::NO_PAGE), height(0), key_count(0),
+      first_leaf(BTreePNode::NO_PAGE), read_only(false),
+      blocks_read(0), blocks_written(0) {}
+
+BTreeP::~BTreeP()
+{
+    close();
+}
+
+const char *BTreeP::pinNode(int page_id)
+{
+    const char *page = Buffer::getBuffer()->fetchPage(index_file, page_id);
+    if (page)
+    {
+        blocks_read++;
+    }
+    return page;
+}
+
+void BTreeP::unpinNode(int page_id)
+{
+    Buffer::getBuffer()->unpinPage(index_file, page_id, false);
+}
+
+bool BTreeP::writeNode(int page_id, const char *page)
+{
+    if (!index_file.writePage(page_id, page))
+    {
+        return false;
+    }
+    blocks_written++;
+    return true;
+}
+
+/**
+ * Header page layout:
+ * [Magic][Version][Page Size][Root][Height][Key Count][First Leaf]
+ */
+bool BTreeP::writeHeader()
+{
+    std::vector<char> header(page_size, 0);
+    writeInt(header.data(), META_MAGIC);
+    writeInt(header.data() + 4, META_VERSION);
+    writeInt(header.data() + 8, page_size);
+    writeInt(header.data() + 12, root_page);
+    writeInt(header.data() + 16, height);
+    writeInt(header.data() + 20, key_count);
+    writeInt(header.data() + 24, first_leaf);
+    return writeNode(0, header.data());
+}
+
+bool BTreeP::readHeader(const std::string &path)
+{
+    // Only the first bytes matter; the page size is learnt from them
+    char header[28];
+    std::ifstream in(path, std::ios::binary);
+    if (!in.read(header, sizeof(header)) || readInt(header) != META_MAGIC ||
+        readInt(header + 4) != META_VERSION)
+    {
+        LOG_ERROR(&logger, "Invalid B+ tree header: " + path);
+        return false;
+    }
+    page_size = readInt(header + 8);
+    root_page = readInt(header + 12);
+    height = readInt(header + 16);
+    key_count = readInt(header + 20);
+    first_leaf = readInt(header + 24);
+    return true;
+}
+
+bool BTreeP::bulkBuild(const std::string &path,
+                       const std::vector<std::pair<int, int>> &sorted_entries,
+                       double fill_factor)
+{
+    fill_factor = std::min(1.0, std::max(0.1, fill_factor));
+    read_only = false;
+    index_file.setPageSize(page_size);
+    if (!index_file.open(path, true))
+    {
+        return false;
+    }
+    page_buffer.assign(page_size, 0);
+    index_file.allocatePage(); // page 0: header
+
+    // Leaves, written left to right; each points to the next page
+    int per_leaf = std::max(1, static_cast<int>(BTreePNode::leafCapacity(page_size) * fill_factor));
+    std::vector<int> leaf_sizes = evenGroups(sorted_entries.size(), per_leaf);
+
+    // (first key, page) of every node in the level being built
+    std::vector<std::pair<int, int>> level;
+    size_t next = 0;
+    for (size_t l = 0; l < leaf_sizes.size(); ++l)
+    {
+        int page_id = index_file.allocatePage();
+        BTreePNode::format(page_buffer.data(), page_size, BTreePNode::LEAF);
+        if (l + 1 < leaf_sizes.size())
+        {
+            BTreePNode::setNextLeaf(page_buffer.data(), page_id + 1);
+        }
+
+        int first_key = next < sorted_entries.size() ? sorted_entries[next].first : 0;
+        for (int i = 0; i < leaf_sizes[l]; ++i, ++next)
+        {
+            BTreePNode::appendLeaf(page_buffer.data(), sorted_entries[next].first,
+                                   sorted_entries[next].second);
+        }
+        if (!writeNode(page_id, page_buffer.data()))
+        {
+            return false;
+        }
+        level.emplace_back(first_key, page_id);
+    }
+    first_leaf = level.front().second;
+    height = 1;
+
+    // Internal levels until a single root remains
+    int per_node = std::max(2, static_cast<int>((BTreePNode::internalCapacity(page_size) + 1) * fill_factor));
+    while (level.size() > 1)
+    {
+        std::vector<int> node_sizes = evenGroups(level.size(), per_node);
+        std::vector<std::pair<int, int>> parents;
+        size_t child = 0;
+        for (int size : node_sizes)
+        {
+            int page_id = index_file.allocatePage();
+            BTreePNode::format(page_buffer.data(), page_size, BTreePNode::INTERNAL);
+            BTreePNode::setFirstChild(page_buffer.data(), level[child].second);
+            parents.emplace_back(level[child].first, page_id);
+            for (int i = 1; i < size; ++i)
+            {
+                BTreePNode::appendInternal(page_buffer.data(), level[child + i].first,
+                                           level[child + i].second);
+            }
+            child += size;
+            if (!writeNode(page_id, page_buffer.data()))
+            {
+                return false;
+            }
+        }
+        level.swap(parents);
+        height++;
+    }
+
+    root_page = level.front().second;
+    key_count = sorted_entries.size();
+    // The header goes last and only once the nodes are on disk, so a
+    // build cut short leaves a file that fails to open, never a tree
+    // pointing at missing nodes
+    if (!index_file.sync() || !writeHeader() || !index_file.sync())
+    {
+        return false;
+    }
+
+    std::ostringstream oss;
+    oss << "B+ tree built at " << path << " - Keys: " << key_count
+        << " Height: " << height << " Pages: " << index_file.getPageCount()
+        << " Fill Factor: " << fill_factor;
+    LOG_INFO(&logger, oss.str());
+    return true;
+}
+
+bool BTreeP::open(const std::string &path, bool readonly, bool mapped)
+{
+    read_only = readonly;
+    if (!readHeader(path))
+    {
+        return false;
+    }
+    index_file.setPageSize(page_size);
+    if (!index_file.open(path, false, read_only))
+    {
+        return false;
+    }
+    if (mapped && read_only)
+    {
+        index_file.map(PageFile::Access::Random);
+    }
+    page_buffer.assign(page_size, 0);
+    return true;
+}
+
+void BTreeP::close()
+{
+    index_file.close();
+}
+
+/**
+ * Leaf page that would hold key, NO_PAGE on a read error
+ */
+int BTreeP::descend(int key)
+{
+    int page_id = root_page;
+    for (int level = height; level > 1; --level)
+    {
+        const char *node = pinNode(page_id);
+        if (!node)
+        {
+            return BTreePNode::NO_PAGE;
+        }
+        int child = BTreePNode::findChild(node, key);
+        unpinNode(page_id);
+        page_id = child;
+    }
+    return page_id;
+}
+
+bool BTreeP::search(int key, int &value)
+{
+    if (root_page == BTreePNode::NO_PAGE)
+    {
+        return false;
+    }
+
+    int page_id = descend(key);
+    if (page_id == BTreePNode::NO_PAGE)
+    {
+        return false;
+    }
+
+    const char *leaf = pinNode(page_id);
+    if (!leaf)
+    {
+        return false;
+    }
+
+    bool found = false;
+    int lo = 0, hi = BTreePNode::getCount(leaf) - 1;
+    while (lo <= hi)
+    {
+        int mid = (lo + hi) / 2;
+        int mid_key = BTreePNode::getLeafKey(leaf, mid);
+        if (mid_key == key)
+        {
+            value = BTreePNode::getLeafValue(leaf, mid);
+            found = true;
+            break;
+        }
+        if (mid_key < key)
+            lo = mid + 1;
+        else
+            hi = mid - 1;
+    }
+    unpinNode(page_id);
+    return found;
+}
+
+int BTreeP::rangeScan(int low, int high, const std::function<bool(int key, int value)> &fn)
+{
+    if (root_page == BTreePNode::NO_PAGE || low > high)
+    {
+        return 0;
+    }
+
+    int visited = 0;
+    int page_id = descend(low);
+    const char *leaf = nullptr;
+    while (page_id != BTreePNode::NO_PAGE && (leaf = pinNode(page_id)) != nullptr)
+    {
+        int next = BTreePNode::getNextLeaf(leaf);
+        // Leaves are written left to right, so the chain continues
+        // with the following pages
+        if (next != BTreePNode::NO_PAGE)
+        {
+            index_file.advise(next, LEAF_READAHEAD, PageFile::Access::WillNeed);
+        }
+
+        int count = BTreePNode::getCount(leaf);
+        // First entry >= low; only the first leaf can start mid-page
+        int lo = 0, hi = count;
+        while (lo < hi)
+        {
+            int mid = (lo + hi) / 2;
+            if (BTreePNode::getLeafKey(leaf, mid) < low)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+
+        for (int i = lo; i < count; ++i)
+        {
+            int key = BTreePNode::getLeafKey(leaf, i);
+            if (key > high)
+            {
+                unpinNode(page_id);
+                return visited;
+            }
+            visited++;
+            if (!fn(key, BTreePNode::getLeafValue(leaf, i)))
+            {
+                unpinNode(page_id);
+                return visited;
+            }
+        }
+        unpinNode(page_id);
+        page_id = next;
+    }
+    return visited;
+}
+
+void BTreeP::printStatistics() const
+{
+    std::ostringstream oss;
+    oss << "\n=== B+ TREE STATISTICS ===\n"
+        << "Keys: " << key_count << "\n"
+        << "Height: " << height << "\n"
+        << "Total Blocks: " << index_file.getPageCount() << "\n"
+        << "Blocks Read: " << blocks_read << "\n"
+        << "Blocks Written: " << blocks_written << "\n";
+
+    LOG_INFO(&logger, oss.str());
+}
@@ -0,0 +1,405 @@
+#include "BTreePString.hpp"
+#include "Buffer.hpp"
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+
+namespace
+{
+    int readInt(const char *ptr)
+    {
+        int value = 0;
+        std::memcpy(&value, ptr, 4);
+        return value;
+    }
+
+    void writeInt(char *ptr, int value)
+    {
+        std::memcpy(ptr, &value, 4);
+    }
+
+    int readShort(const char *ptr)
+    {
+        uint16_t value = 0;
+        std::memcpy(&value, ptr, 2);
+        return value;
+    }
+
+    void writeShort(char *ptr, int value)
+    {
+        uint16_t v = static_cast<uint16_t>(value);
+        std::memcpy(ptr, &v, 2);
+    }
+
+    int commonPrefix(const std::string &a, const std::string &b)
+    {
+        size_t n = std::min(a.size(), b.size());
+        size_t i = 0;
+        while (i < n && a[i] == b[i])
+        {
+            i++;
+        }
+        return static_cast<int>(i);
+    }
+
+    void formatNode(char *page, int page_size, int type)
+    {
+        std::memset(page, 0, page_size);
+        writeInt(page, type);
+        writeInt(page + 8, BTreePStringNode::NO_PAGE);
+    }
+
+    // A node of the level being built and the separator that routes to it
+    struct LevelEntry
+    {
+        std::string separator;
+        int page_id;
+    };
+}
+
+BTreePString::BTreePString(Logger &log, int pg_size)
+    : logger(log), index_file(log, pg_size), page_size(pg_size),
+      root_page(BTreePStringNode::NO_PAGE), height(0), key_count(0),
+      first_leaf(BTreePStringNode::NO_PAGE), blocks_read(0), blocks_written(0) {}
+
+BTreePString::~BTreePString()
+{
+    close();
+}
+
+int BTreePString::maxKeySize() const
+{
+    // A leaf must hold one entry and an internal node child 0 plus one separator
+    return std::min(BTreePStringNode::MAX_KEY_SIZE, page_size - BTreePStringNode::HEADER_SIZE - 12);
+}
+
+std::string BTreePString::shortestSeparator(const std::string &left, const std::string &right)
+{
+    // The shortest prefix of right that is still >= left
+    size_t len = std::min(right.size(), static_cast<size_t>(commonPrefix(left, right)) + 1);
+    return right.substr(0, len);
+}
+
+const char *BTreePString::pinNode(int page_id)
+{
+    const char *page = Buffer::getBuffer()->fetchPage(index_file, page_id);
+    if (page)
+    {
+        blocks_read++;
+    }
+    return page;
+}
+
+void BTreePString::unpinNode(int page_id)
+{
+    Buffer::getBuffer()->unpinPage(index_file, page_id, false);
+}
+
+bool BTreePString::writeNode(int page_id, const char *page)
+{
+    if (!index_file.writePage(page_id, page))
+    {
+        return false;
+    }
+    blocks_written++;
+    return true;
+}
+
+/**
+ * Header page layout:
+ * [Magic][Version][Page Size][Root][Height][Key Count][First Leaf]
+ */
+bool BTreePString::writeHeader()
+{
+    std::vector<char> header(page_size, 0);
+    writeInt(header.data(), META_MAGIC);
+    writeInt(header.data() + 4, META_VERSION);
+    writeInt(header.data() + 8, page_size);
+    writeInt(header.data() + 12, root_page);
+    writeInt(header.data() + 16, height);
+    writeInt(header.data() + 20, key_count);
+    writeInt(header.data() + 24, first_leaf);
+    return writeNode(0, header.data());
+}
+
+bool BTreePString::readHeader(const std::string &path)
+{
+    char header[28];
+    std::ifstream in(path, std::ios::binary);
+    if (!in.read(header, sizeof(header)) || readInt(header) != META_MAGIC ||
+        readInt(header + 4) != META_VERSION)
+    {
+        LOG_ERROR(&logger, "Invalid B+ tree header: " + path);
+        return false;
+    }
+    page_size = readInt(header + 8);
+    root_page = readInt(header + 12);
+    height = readInt(header + 16);
+    key_count = readInt(header + 20);
+    first_leaf = readInt(header + 24);
+    return true;
+}
+
+bool BTreePString::bulkBuild(const std::string &path,
+                             const std::vector<std::pair<std::string, RecordLocation>> &sorted_entries,
+                             double fill_factor)
+{
+    fill_factor = std::min(1.0, std::max(0.1, fill_factor));
+    index_file.setPageSize(page_size);
+    if (!index_file.open(path, true))
+    {
+        return false;
+    }
+    page_buffer.assign(page_size, 0);
+    index_file.allocatePage(); // page 0: header
+
+    // The first entry of a node is always taken, the limit applies after it
+    int limit = std::min(page_size, static_cast<int>(page_size * fill_factor));
+
+    // Leaves: front compressed against the previous key of the same leaf
+    std::vector<LevelEntry> level;
+    std::string prev_key, last_of_previous_leaf;
+    int used = BTreePStringNode::HEADER_SIZE;
+    int count = 0;
+    int page_id = index_file.allocatePage();
+    formatNode(page_buffer.data(), page_size, BTreePStringNode::LEAF);
+
+    for (const auto &entry : sorted_entries)
+    {
+        std::string key = entry.first.substr(0, maxKeySize());
+        int prefix = count == 0 ? 0 : commonPrefix(prev_key, key);
+        int suffix = static_cast<int>(key.size()) - prefix;
+
+        if (count > 0 && used + BTreePStringNode::leafEntrySize(suffix) > limit)
+        {
+            writeInt(page_buffer.data() + 4, count);
+            writeInt(page_buffer.data() + 8, page_id + 1); // next leaf is the next page
+            if (!writeNode(page_id, page_buffer.data()))
+            {
+                return false;
+            }
+            last_of_previous_leaf = prev_key;
+
+            page_id = index_file.allocatePage();
+            formatNode(page_buffer.data(), page_size, BTreePStringNode::LEAF);
+            used = BTreePStringNode::HEADER_SIZE;
+            count = 0;
+            prefix = 0;
+            suffix = key.size();
+        }
+
+        if (count == 0)
+        {
+            std::string separator = level.empty() ? "" : shortestSeparator(last_of_previous_leaf, key);
+            level.push_back({separator, page_id});
+        }
+
+        char *slot = page_buffer.data() + used;
+        writeShort(slot, prefix);
+        writeShort(slot + 2, suffix);
+        std::memcpy(slot + 4, key.data() + prefix, suffix);
+        writeInt(slot + 4 + suffix, entry.second.record_id);
+        writeInt(slot + 8 + suffix, entry.second.block_id);
+        used += BTreePStringNode::leafEntrySize(suffix);
+        count++;
+        prev_key = key;
+    }
+
+    writeInt(page_buffer.data() + 4, count);
+    if (!writeNode(page_id, page_buffer.data()))
+    {
+        return false;
+    }
+    if (level.empty())
+    {
+        level.push_back({"", page_id});
+    }
+    first_leaf = level.front().page_id;
+    height = 1;
+
+    // Internal levels: a node is routed to by the separator of its first child
+    while (level.size() > 1)
+    {
+        std::vector<LevelEntry> parents;
+        for (size_t i = 0; i < level.size();)
+        {
+            page_id = index_file.allocatePage();
+            formatNode(page_buffer.data(), page_size, BTreePStringNode::INTERNAL);
+            writeInt(page_buffer.data() + BTreePStringNode::HEADER_SIZE, level[i].page_id);
+            parents.push_back({level[i].separator, page_id});
+            used = BTreePStringNode::HEADER_SIZE + 4;
+            count = 0;
+
+            for (++i; i < level.size(); ++i)
+            {
+                const std::string &sep = level[i].separator;
+                int size = BTreePStringNode::internalEntrySize(sep.size());
+                if (count > 0 && used + size > limit)
+                {
+                    break;
+                }
+                char *slot = page_buffer.data() + used;
+                writeShort(slot, sep.size());
+                std::memcpy(slot + 2, sep.data(), sep.size());
+                writeInt(slot + 2 + sep.size(), level[i].page_id);
+                used += size;
+                count++;
+            }
+
+            writeInt(page_buffer.data() + 4, count);
+            if (!writeNode(page_id, page_buffer.data()))
+            {
+                return false;
+            }
+        }
+        level.swap(parents);
+        height++;
+    }
+
+    root_page = level.front().page_id;
+    key_count = sorted_entries.size();
+    // The header goes last and only once the nodes are on disk, so a
+    // build cut short leaves a file that fails to open, never a tree
+    // pointing at missing nodes
+    if (!index_file.sync() || !writeHeader() || !index_file.sync())
+    {
+        return false;
+    }
+
+    std::ostringstream oss;
+    oss << "String B+ tree built at " << path << " - Keys: " << key_count
+        << " Height: " << height << " Pages: " << index_file.getPageCount()
+        << " Fill Factor: " << fill_factor;
+    LOG_INFO(&logger, oss.str());
+    return true;
+}
+
+bool BTreePString::open(const std::string &path, bool mapped)
+{
+    if (!readHeader(path))
+    {
+        return false;
+    }
+    index_file.setPageSize(page_size);
+    if (!index_file.open(path, false, true))
+    {
+        return false;
+    }
+    if (mapped)
+    {
+        index_file.map(PageFile::Access::Random);
+    }
+    page_buffer.assign(page_size, 0);
+    return true;
+}
+
+void BTreePString::close()
+{
+    index_file.close();
+}
+
+/**
+ * Leftmost leaf that can hold key: follow the child before the first
+ * separator >= key
+ */
+int BTreePString::descend(const std::string &key)
+{
+    int page_id = root_page;
+    for (int level = height; level > 1; --level)
+    {
+        const char *page = pinNode(page_id);
+        if (!page)
+        {
+            return BTreePStringNode::NO_PAGE;
+        }
+        int count = readInt(page + 4);
+        int child = readInt(page + BTreePStringNode::HEADER_SIZE);
+        int offset = BTreePStringNode::HEADER_SIZE + 4;
+        for (int i = 0; i < count; ++i)
+        {
+            int len = readShort(page + offset);
+            if (key.compare(0, std::string::npos, page + offset + 2, len) <= 0)
+            {
+                break;
+            }
+            child = readInt(page + offset + 2 + len);
+            offset += BTreePStringNode::internalEntrySize(len);
+        }
+        unpinNode(page_id);
+        page_id = child;
+    }
+    return page_id;
+}
+
+bool BTreePString::search(const std::string &key, std::vector<RecordLocation> &out)
+{
+    return scan(key, false, out);
+}
+
+bool BTreePString::searchPrefix(const std::string &prefix, std::vector<RecordLocation> &out)
+{
+    return scan(prefix, true, out);
+}
+
+/**
+ * Leaf scan from the leftmost leaf that can hold key, matching either
+ * the whole key or keys that start with it
+ */
+bool BTreePString::scan(const std::string &key, bool match_prefix, std::vector<RecordLocation> &out)
+{
+    if (root_page == BTreePStringNode::NO_PAGE)
+    {
+        return false;
+    }
+
+    std::string target = key.substr(0, maxKeySize());
+    size_t found = out.size();
+    int page_id = descend(target);
+    std::string current;
+    // Leaves are contiguous and chained in file order, so the scan reads ahead
+    index_file.advise(page_id, index_file.getPageCount() - page_id, PageFile::Access::Sequential);
+
+    const char *page = nullptr;
+    while (page_id != BTreePStringNode::NO_PAGE && (page = pinNode(page_id)) != nullptr)
+    {
+        int count = readInt(page + 4);
+        int offset = BTreePStringNode::HEADER_SIZE;
+        for (int i = 0; i < count; ++i)
+        {
+            int prefix = readShort(page + offset);
+            int suffix = readShort(page + offset + 2);
+            current.resize(prefix);
+            current.append(page + offset + 4, suffix);
+
+            int cmp = match_prefix ? current.compare(0, target.size(), target) : current.compare(target);
+            if (cmp > 0)
+            {
+                unpinNode(page_id);
+                return out.size() > found;
+            }
+            if (cmp == 0)
+            {
+                out.push_back({readInt(page + offset + 4 + suffix),
+                               readInt(page + offset + 8 + suffix)});
+            }
+            offset += BTreePStringNode::leafEntrySize(suffix);
+        }
+        int next = readInt(page + 8);
+        unpinNode(page_id);
+        page_id = next;
+    }
+    return out.size() > found;
+}
+
+void BTreePString::printStatistics() const
+{
+    std::ostringstream oss;
+    oss << "\n=== STRING B+ TREE STATISTICS ===\n"
+        << "Keys: " << key_count << "\n"
+        << "Height: " << height << "\n"
+        << "Total Blocks: " << index_file.getPageCount() << "\n"
+        << "Blocks Read: " << blocks_read << "\n"
+        << "Blocks Written: " << blocks_written << "\n";
+
+    LOG_INFO(&logger, oss.str());
+}
@@ -0,0 +1,253 @@
+#include "Buffer.hpp"
+#include <cstring>
+
+Buffer* Buffer::buffer = nullptr;
+
+Buffer* Buffer::getBuffer(){
+    if(buffer == nullptr){
+        buffer = new Buffer();
+    }
+    return buffer;
+}
+
+Buffer::Buffer()
+    : frame_count(0), frame_size(0), clock_hand(0), hits(0), misses(0), evictions(0)
+{
+    configure(1024, 4096);
+}
+
+bool Buffer::configure(int frames_wanted, int size)
+{
+    std::lock_guard<std::mutex> lock(buffer_mutex);
+    for (const auto &frame : frames)
+    {
+        if (frame.pin_count > 0)
+        {
+            LOG_ERROR(Logger::getLogger(), "Buffer pool resize with pinned pages");
+            return false;
+        }
+    }
+    for (int i = 0; i < frame_count; ++i)
+    {
+        writeBack(i);
+    }
+
+    frame_count = frames_wanted > 0 ? frames_wanted : 1;
+    frame_size = size;
+    pool.assign(static_cast<size_t>(frame_count) * frame_size, 0);
+    frames.assign(frame_count, Frame{nullptr, -1, 0, false, false});
+    page_table.clear();
+    clock_hand = 0;
+    return true;
+}
+
+bool Buffer::writeBack(int frame)
+{
+    Frame &f = frames[frame];
+    if (!f.file || !f.dirty)
+    {
+        return true;
+    }
+    if (!f.file->writePage(f.page_id, frameData(frame)))
+    {
+        return false;
+    }
+    f.dirty = false;
+    return true;
+}
+
+/**
+ * CLOCK: sweep the frames, giving referenced ones a second chance
+ * Two full turns without a victim means everything is pinned
+ */
+int Buffer::findVictim()
+{
+    for (int step = 0; step < 2 * frame_count; ++step)
+    {
+        int frame = clock_hand;
+        clock_hand = (clock_hand + 1) % frame_count;
+
+        Frame &f = frames[frame];
+        if (f.pin_count > 0)
+            continue;
+        if (f.referenced)
+        {
+            f.referenced = false;
+            continue;
+        }
+        return frame;
+    }
+    return -1;
+}
+
+int Buffer::claimFrame(PageFile &file, int page_id)
+{
+    if (file.getPageSize() > frame_size)
+    {
+        LOG_ERROR(Logger::getLogger(), "Page size " + std::to_string(file.getPageSize()) +
+                                           " larger than buffer frames (" + std::to_string(frame_size) + ")");
+        return -1;
+    }
+
+    int frame = findVictim();
+    if (frame < 0)
+    {
+        LOG_ERROR(Logger::getLogger(), "Buffer pool exhausted: every frame is pinned");
+        return -1;
+    }
+
+    Frame &f = frames[frame];
+    if (f.file)
+    {
+        if (!writeBack(frame))
+        {
+            return -1;
+        }
+        page_table.erase(pageKey(*f.file, f.page_id));
+        evictions++;
+    }
+
+    f = Frame{&file, page_id, 1, false, true};
+    page_table[pageKey(file, page_id)] = frame;
+    return frame;
+}
+
+char *Buffer::fetchPage(PageFile &file, int page_id)
+{
+    // A mapped file is already cached by the OS; no frame is used and
+    // unpinPage finds nothing to release. Mapped files are read-only,
+    // so callers never write through this pointer
+    if (file.isMapped())
+    {
+        return const_cast<char *>(file.mappedPage(page_id));
+    }
+
+    std::lock_guard<std::mutex> lock(buffer_mutex);
+
+    auto it = page_table.find(pageKey(file, page_id));
+    if (it != page_table.end())
+    {
+        Frame &f = frames[it->second];
+        f.pin_count++;
+        f.referenced = true;
+        hits++;
+        return frameData(it->second);
+    }
+
+    int frame = claimFrame(file, page_id);
+    if (frame < 0)
+    {
+        return nullptr;
+    }
+    if (!file.readPage(page_id, frameData(frame)))
+    {
+        page_table.erase(pageKey(file, page_id));
+        frames[frame] = Frame{nullptr, -1, 0, false, false};
+        return nullptr;
+    }
+    misses++;
+    return frameData(frame);
+}
+
+char *Buffer::newPage(PageFile &file, int page_id)
+{
+    std::lock_guard<std::mutex> lock(buffer_mutex);
+
+    auto it = page_table.find(pageKey(file, page_id));
+    int frame = it != page_table.end() ? it->second : claimFrame(file, page_id);
+    if (frame < 0)
+    {
+        return nullptr;
+    }
+    if (it != page_table.end())
+    {
+        frames[frame].pin_count++;
+    }
+    frames[frame].dirty = true;
+    std::memset(frameData(frame), 0, frame_size);
+    return frameData(frame);
+}
+
+void Buffer::unpinPage(PageFile &file, int page_id, bool dirty)
+{
+    std::lock_guard<std::mutex> lock(buffer_mutex);
+
+    auto it = page_table.find(pageKey(file, page_id));
+    if (it == page_table.end())
+    {
+        return;
+    }
+    Frame &f = frames[it->second];
+    if (f.pin_count > 0)
+    {
+        f.pin_count--;
+    }
+    f.dirty = f.dirty || dirty;
+}
+
+void Buffer::discardPage(PageFile &file, int page_id)
+{
+    std::lock_guard<std::mutex> lock(buffer_mutex);
+
+    auto it = page_table.find(pageKey(file, page_id));
+    if (it == page_table.end())
+    {
+        return;
+    }
+    frames[it->second] = Frame{nullptr, -1, 0, false, false};
+    page_table.erase(it);
+}
+
+bool Buffer::flushFile(PageFile &file)
+{
+    std::lock_guard<std::mutex> lock(buffer_mutex);
+    bool ok = true;
+    for (int i = 0; i < frame_count; ++i)
+    {
+        if (frames[i].file == &file)
+        {
+            ok = writeBack(i) && ok;
+        }
+    }
+    file.flush();
+    return ok;
+}
+
+void Buffer::dropFile(PageFile &file)
+{
+    flushFile(file);
+
+    std::lock_guard<std::mutex> lock(buffer_mutex);
+    for (int i = 0; i < frame_count; ++i)
+    {
+        Frame &f = frames[i];
+        if (f.file == &file)
+        {
+            page_table.erase(pageKey(file, f.page_id));
+            f = Frame{nullptr, -1, 0, false, false};
+        }
+    }
+}
+
+bool Buffer::flushAll()
+{
+    std::lock_guard<std::mutex> lock(buffer_mutex);
+    bool ok = true;
+    for (int i = 0; i < frame_count; ++i)
+    {
+        ok = writeBack(i) && ok;
+    }
+    return ok;
+}
+
+void Buffer::printStatistics()
+{
+    std::lock_guard<std::mutex> lock(buffer_mutex);
+    std::ostringstream oss;
+    oss << "\n=== BUFFER POOL STATISTICS ===\n"
+        << "Frames: " << frame_count << " x " << frame_size << " bytes\n"
+        << "Hits: " << hits << "\n"
+        << "Misses: " << misses << "\n"
+        << "Evictions: " << evictions << "\n";
+    LOG_INFO(Logger::getLogger(), oss.str());
+}
@@ -0,0 +1,105 @@
+#include "Collation.hpp"
+
+namespace
+{
+    // Base letter of U+00C0..U+00FF, '.' where there is none
+    const char LATIN1_BASE[] =
+        "aaaaaaaceeeeiiii"  // C0..CF
+        "dnooooo.ouuuuy.."  // D0..DF (sharp s handled apart)
+        "aaaaaaaceeeeiiii"  // E0..EF
+        "dnooooo.ouuuuy.y"; // F0..FF
+
+    char lower(char c)
+    {
+        return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+
+    /**
+     * Folded form of the entity name between '&' and ';', empty if unknown
+     */
+    std::string_view entity(std::string_view name)
+    {
+        if (name == "amp")
+            return "&";
+        if (name == "quot")
+            return "\"";
+        if (name == "apos")
+            return "'";
+        if (name == "lt")
+            return "<";
+        if (name == "gt")
+            return ">";
+        if (name == "szlig")
+            return "ss";
+
+        // Letter followed by an accent name: &ouml; &Eacute; &ccedil; ...
+        static const char *const accents[] = {"uml", "acute", "grave", "circ", "tilde", "cedil", "ring", "slash"};
+        static const char letters[] = "acdeinouyACDEINOUY";
+        static const char folded[] = "acdeinouyacdeinouy";
+        if (name.size() < 3)
+            return std::string_view();
+        for (const char *accent : accents)
+        {
+            if (name.substr(1) != accent)
+                continue;
+            for (int i = 0; letters[i]; ++i)
+            {
+                if (letters[i] == name[0])
+                    return std::string_view(folded + i, 1);
+            }
+        }
+        return std::string_view();
+    }
+}
+
+std::string Collation::fold(std::string_view text)
+{
+    std::string out;
+    out.reserve(text.size());
+    size_t i = 0;
+    while (i < text.size())
+    {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+
+        // Two-byte UTF-8 for U+00C0..U+00FF: lead byte C3
+        if (c == 0xC3 && i + 1 < text.size())
+        {
+            unsigned char next = static_cast<unsigned char>(text[i + 1]);
+            if (next >= 0x80 && next <= 0xBF)
+            {
+                char base = LATIN1_BASE[next - 0x80];
+                if (next == 0x9F)
+                {
+                    out += "ss";
+                    i += 2;
+                    continue;
+                }
+                if (base != '.')
+                {
+                    out += base;
+                    i += 2;
+                    continue;
+                }
+            }
+        }
+
+        if (c == '&')
+        {
+            size_t end = text.find(';', i + 1);
+            if (end != std::string_view::npos && end - i <= 8)
+            {
+                std::string_view replacement = entity(text.substr(i + 1, end - i - 1));
+                if (!replacement.empty())
+                {
+                    out += replacement;
+                    i = end + 1;
+                    continue;
+                }
+            }
+        }
+
+        out += lower(static_cast<char>(c));
+        i++;
+    }
+    return out;
+}
@@ -0,0 +1,378 @@
+#include "CsvPipeline.hpp"
+#include "CsvScanner.hpp"
+#include <fstream>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+CsvPipeline::CsvPipeline(Logger &log, const std::vector<FieldSpec> &schema_fields,
+                         int threads, bool mapped, size_t chunk_bytes)
+    : logger(log), schema(schema_fields), layout(schema_fields), parser_threads(threads), use_mmap(mapped), chunk_size(chunk_bytes),
+      max_in_flight(0), reader_done(false), failed(false), chunks_total(0), next_to_write(0),
+      records_read(0), inserted(0), skipped(0)
+{
+    if (parser_threads <= 0)
+    {
+        parser_threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+    if (chunk_size == 0)
+    {
+        chunk_size = 4 << 20;
+    }
+}
+
+/**
+ * Cut the file into chunks of whole rows
+ * A row ends at a newline outside quotes; "" toggles the state twice,
+ * so counting quotes is enough to follow it
+ */
+void CsvPipeline::readerLoop(const std::string &path)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open())
+    {
+        LOG_ERROR(&logger, "Could not open CSV file: " + path);
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        failed = true;
+        reader_done = true;
+        chunk_ready.notify_all();
+        batch_ready.notify_all();
+        return;
+    }
+
+    std::vector<char> buffer(chunk_size);
+    std::vector<uint32_t> structural;
+    std::string data;
+    bool in_quotes = false;
+    int seq = 0;
+    int line = 1;
+
+    while (true)
+    {
+        in.read(buffer.data(), buffer.size());
+        size_t got = static_cast<size_t>(in.gcount());
+        bool eof = got < buffer.size();
+
+        size_t scanned = data.size();
+        data.append(buffer.data(), got);
+
+        size_t cut = std::string::npos;
+        int rows = 0;
+        structural.clear();
+        CsvScanner::scan(data.data() + scanned, data.size() - scanned, structural);
+        for (uint32_t offset : structural)
+        {
+            size_t i = scanned + offset;
+            if (data[i] == '"')
+            {
+                in_quotes = !in_quotes;
+            }
+            else if (data[i] == '\n' && !in_quotes)
+            {
+                cut = i + 1;
+                rows++;
+            }
+        }
+
+        // The tail without a newline is either the last row or the start
+        // of one that continues in the next read
+        std::string rest;
+        if (eof)
+        {
+            if (cut != data.size() && !data.empty())
+            {
+                rows++;
+            }
+            cut = data.size();
+        }
+        else if (cut == std::string::npos)
+        {
+            continue;
+        }
+        else
+        {
+            rest = data.substr(cut);
+            data.resize(cut);
+        }
+
+        if (!data.empty())
+        {
+            pushChunk({seq++, line, nullptr, 0, std::move(data)});
+        }
+        line += rows;
+        data = std::move(rest);
+
+        if (eof)
+        {
+            break;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(queue_mutex);
+    chunks_total = seq;
+    reader_done = true;
+    chunk_ready.notify_all();
+    batch_ready.notify_all();
+}
+
+/**
+ * Split a mapped file into ranges of about chunk_size bytes
+ * Pass 1 (parallel) counts quotes and newlines per range; the quote
+ * parity before each range then tells where its first whole row starts
+ */
+void CsvPipeline::readMapped(const char *base, size_t len)
+{
+    size_t ranges = (len + chunk_size - 1) / chunk_size;
+    std::vector<RangeCount> counts(ranges, RangeCount{0, 0, false});
+
+    std::atomic<size_t> next_range(0);
+    std::vector<std::thread> counters;
+    for (int t = 0; t < parser_threads; ++t)
+    {
+        counters.emplace_back([&]
+                              {
+            std::vector<uint32_t> structural;
+            for (size_t r; (r = next_range++) < ranges;)
+            {
+                size_t begin = r * chunk_size;
+                size_t end = std::min(len, begin + chunk_size);
+                structural.clear();
+                CsvScanner::scan(base + begin, end - begin, structural);
+
+                bool quoted = false;
+                for (uint32_t offset : structural)
+                {
+                    char c = base[begin + offset];
+                    if (c == '"')
+                        quoted = !quoted;
+                    else if (c == '\n')
+                        (quoted ? counts[r].rows_quoted : counts[r].rows_plain)++;
+                }
+                counts[r].odd_quotes = quoted;
+            } });
+    }
+    for (auto &t : counters)
+    {
+        t.join();
+    }
+
+    // Pass 2: each range starts after the first newline outside quotes
+    // at or past its nominal begin
+    int seq = 0;
+    int rows_before = 0; // rows ending before the nominal begin
+    bool quoted = false; // state at the nominal begin
+    size_t cut = 0;
+    int cut_line = 1;
+    for (size_t r = 0; r < ranges; ++r)
+    {
+        size_t next_begin = (r + 1) * chunk_size;
+        rows_before += quoted ? counts[r].rows_quoted : counts[r].rows_plain;
+        quoted = quoted != counts[r].odd_quotes;
+
+        size_t next_cut = len;
+        int next_line = 0;
+        if (next_begin < len)
+        {
+            next_line = rows_before + 1;
+            if (!quoted && base[next_begin - 1] == '\n')
+            {
+                next_cut = next_begin;
+            }
+            else
+            {
+                bool q = quoted;
+                for (size_t i = next_begin; i < len; ++i)
+                {
+                    if (base[i] == '"')
+                        q = !q;
+                    else if (base[i] == '\n' && !q)
+                    {
+                        next_cut = i + 1;
+                        next_line++;
+                        break;
+                    }
+                }
+            }
+        }
+
+        if (next_cut > cut)
+        {
+            pushChunk({seq++, cut_line, base + cut, next_cut - cut, std::string()});
+            cut = next_cut;
+            cut_line = next_line;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(queue_mutex);
+    chunks_total = seq;
+    reader_done = true;
+    chunk_ready.notify_all();
+    batch_ready.notify_all();
+}
+
+void CsvPipeline::pushChunk(Chunk chunk)
+{
+    std::unique_lock<std::mutex> lock(queue_mutex);
+    slot_free.wait(lock, [&]
+                   { return chunk.seq - next_to_write < max_in_flight; });
+    chunks.push_back(std::move(chunk));
+    chunk_ready.notify_one();
+}
+
+void CsvPipeline::parserLoop()
+{
+    while (true)
+    {
+        Chunk chunk;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex);
+            chunk_ready.wait(lock, [&]
+                             { return !chunks.empty() || reader_done; });
+            if (chunks.empty())
+            {
+                return;
+            }
+            chunk = std::move(chunks.front());
+            chunks.pop_front();
+        }
+
+        Batch batch = parseChunk(chunk);
+
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        batches[chunk.seq] = std::move(batch);
+        batch_ready.notify_all();
+    }
+}
+
+CsvPipeline::Batch CsvPipeline::parseChunk(const Chunk &chunk)
+{
+    const char *bytes = chunk.mapped ? chunk.mapped : chunk.data.data();
+    size_t size = chunk.mapped ? chunk.size : chunk.data.size();
+
+    Batch batch{{}, {}, 0};
+    batch.records.reserve(size + size / 4);
+
+    CsvScanner scanner;
+    scanner.reset(bytes, size);
+    int line = chunk.first_line;
+    std::vector<std::string_view> tokens;
+    std::string error;
+
+    while (scanner.nextRow(tokens))
+    {
+        if (tokens.size() != schema.size())
+        {
+            LOG_WARN(&logger, "Line " + std::to_string(line) + " has " +
+                                  std::to_string(tokens.size()) + " fields, expected " +
+                                  std::to_string(schema.size()));
+            batch.skipped++;
+            line++;
+            continue;
+        }
+
+        size_t start = batch.records.size();
+        if (layout.encode(tokens, batch.records, error))
+        {
+            batch.sizes.push_back(static_cast<int>(batch.records.size() - start));
+        }
+        else
+        {
+            LOG_WARN(&logger, "Line " + std::to_string(line) + ": failed to parse record: " + error);
+            batch.skipped++;
+        }
+        line++;
+    }
+    return batch;
+}
+
+bool CsvPipeline::run(const std::string &path, const Sink &sink)
+{
+    chunks.clear();
+    batches.clear();
+    max_in_flight = 2 * parser_threads + 2;
+    reader_done = false;
+    failed = false;
+    chunks_total = 0;
+    next_to_write = 0;
+    records_read = inserted = skipped = 0;
+
+    // Map the input when possible; an empty or unmappable file goes
+    // through the buffered reader
+    const char *mapped = nullptr;
+    size_t mapped_size = 0;
+    if (use_mmap)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        struct stat st;
+        if (fd >= 0 && ::fstat(fd, &st) == 0 && st.st_size > 0)
+        {
+            void *addr = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr != MAP_FAILED)
+            {
+                mapped = static_cast<const char *>(addr);
+                mapped_size = static_cast<size_t>(st.st_size);
+                ::madvise(addr, mapped_size, MADV_SEQUENTIAL);
+            }
+        }
+        if (fd >= 0)
+        {
+            ::close(fd);
+        }
+    }
+
+    std::thread reader = mapped ? std::thread(&CsvPipeline::readMapped, this, mapped, mapped_size)
+                                : std::thread(&CsvPipeline::readerLoop, this, path);
+    std::vector<std::thread> parsers;
+    for (int i = 0; i < parser_threads; ++i)
+    {
+        parsers.emplace_back(&CsvPipeline::parserLoop, this);
+    }
+
+    // Writer stage: batches are consumed in file order on this thread
+    while (true)
+    {
+        Batch batch;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex);
+            batch_ready.wait(lock, [&]
+                             { return batches.count(next_to_write) > 0 ||
+                                      (reader_done && next_to_write >= chunks_total); });
+            auto it = batches.find(next_to_write);
+            if (it == batches.end())
+            {
+                break;
+            }
+            batch = std::move(it->second);
+            batches.erase(it);
+            next_to_write++;
+        }
+        slot_free.notify_one();
+
+        size_t offset = 0;
+        for (int size : batch.sizes)
+        {
+            if (sink(batch.records.data() + offset, size))
+                inserted++;
+            else
+                skipped++;
+            offset += size;
+        }
+        skipped += batch.skipped;
+        records_read += static_cast<int>(batch.sizes.size()) + batch.skipped;
+    }
+
+    reader.join();
+    for (auto &t : parsers)
+    {
+        t.join();
+    }
+    if (mapped)
+    {
+        ::munmap(const_cast<char *>(mapped), mapped_size);
+    }
+    return !failed;
+}
@@ -0,0 +1,233 @@
+#include "CsvScanner.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define CSV_SCANNER_X86 1
+#endif
+
+namespace
+{
+    inline bool isStructural(char c)
+    {
+        return c == ';' || c == '"' || c == '\n' || c == '\r';
+    }
+
+    void scanScalar(const char *data, size_t begin, size_t len, std::vector<uint32_t> &out)
+    {
+        for (size_t i = begin; i < len; ++i)
+        {
+            if (isStructural(data[i]))
+            {
+                out.push_back(static_cast<uint32_t>(i));
+            }
+        }
+    }
+
+    // One bit per byte of the block, lowest bit first
+    inline void emitMask(uint32_t mask, size_t base, std::vector<uint32_t> &out)
+    {
+        while (mask)
+        {
+            out.push_back(static_cast<uint32_t>(base + __builtin_ctz(mask)));
+            mask &= mask - 1;
+        }
+    }
+
+#ifdef CSV_SCANNER_X86
+    __attribute__((target("sse2"))) size_t scanSse2(const char *data, size_t len, std::vector<uint32_t> &out)
+    {
+        const __m128i semi = _mm_set1_epi8(';');
+        const __m128i quote = _mm_set1_epi8('"');
+        const __m128i nl = _mm_set1_epi8('\n');
+        const __m128i cr = _mm_set1_epi8('\r');
+
+        size_t i = 0;
+        for (; i + 16 <= len; i += 16)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+            __m128i hits = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, semi), _mm_cmpeq_epi8(v, quote)),
+                                        _mm_or_si128(_mm_cmpeq_epi8(v, nl), _mm_cmpeq_epi8(v, cr)));
+            emitMask(static_cast<uint32_t>(_mm_movemask_epi8(hits)), i, out);
+        }
+        return i;
+    }
+
+    __attribute__((target("avx2"))) size_t scanAvx2(const char *data, size_t len, std::vector<uint32_t> &out)
+    {
+        const __m256i semi = _mm256_set1_epi8(';');
+        const __m256i quote = _mm256_set1_epi8('"');
+        const __m256i nl = _mm256_set1_epi8('\n');
+        const __m256i cr = _mm256_set1_epi8('\r');
+
+        size_t i = 0;
+        for (; i + 32 <= len; i += 32)
+        {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+            __m256i hits = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, semi), _mm256_cmpeq_epi8(v, quote)),
+                                           _mm256_or_si256(_mm256_cmpeq_epi8(v, nl), _mm256_cmpeq_epi8(v, cr)));
+            emitMask(static_cast<uint32_t>(_mm256_movemask_epi8(hits)), i, out);
+        }
+        return i;
+    }
+#endif
+}
+
+CsvScanner::Level CsvScanner::detect()
+{
+#ifdef CSV_SCANNER_X86
+    static const Level level = __builtin_cpu_supports("avx2")   ? Level::AVX2
+                               : __builtin_cpu_supports("sse2") ? Level::SSE2
+                                                                : Level::Scalar;
+    return level;
+#else
+    return Level::Scalar;
+#endif
+}
+
+const char *CsvScanner::levelName(Level level)
+{
+    switch (level)
+    {
+    case Level::AVX2:
+        return "AVX2";
+    case Level::SSE2:
+        return "SSE2";
+    default:
+        return "scalar";
+    }
+}
+
+void CsvScanner::scan(const char *data, size_t len, std::vector<uint32_t> &out)
+{
+    scan(data, len, out, detect());
+}
+
+void CsvScanner::scan(const char *data, size_t len, std::vector<uint32_t> &out, Level level)
+{
+    size_t done = 0;
+#ifdef CSV_SCANNER_X86
+    if (level == Level::AVX2)
+        done = scanAvx2(data, len, out);
+    else if (level == Level::SSE2)
+        done = scanSse2(data, len, out);
+#else
+    (void)level;
+#endif
+    scanScalar(data, done, len, out);
+}
+
+void CsvScanner::reset(const char *buffer, size_t len)
+{
+    data = buffer;
+    length = len;
+    position = 0;
+    next_offset = 0;
+    offsets.clear();
+    scan(data, length, offsets);
+}
+
+bool CsvScanner::nextRow(std::vector<std::string_view> &fields)
+{
+    if (position >= length)
+    {
+        return false;
+    }
+
+    pieces.clear();
+    scratch.clear();
+    Piece field{position, 0, false};
+
+    // The first run of a field is only referenced; a second run (or an
+    // escaped quote) moves the field to the scratch string
+    auto toScratch = [&]()
+    {
+        if (!field.in_scratch)
+        {
+            size_t begin = scratch.size();
+            scratch.append(data + field.begin, field.size);
+            field = {begin, field.size, true};
+        }
+    };
+    auto keep = [&](size_t from, size_t to)
+    {
+        if (from == to)
+            return;
+        if (field.size == 0 && !field.in_scratch)
+        {
+            field.begin = from;
+        }
+        else if (field.in_scratch || field.begin + field.size != from)
+        {
+            toScratch();
+            scratch.append(data + from, to - from);
+        }
+        field.size += to - from;
+    };
+    auto endField = [&](size_t next)
+    {
+        pieces.push_back(field);
+        field = {next, 0, false};
+    };
+
+    bool in_quotes = false;
+    bool row_done = false;
+    while (next_offset < offsets.size())
+    {
+        size_t at = offsets[next_offset++];
+        char c = data[at];
+
+        // Inside quotes only a quote is special; the rest is kept later
+        if (in_quotes)
+        {
+            if (c != '"')
+                continue;
+            keep(position, at);
+            if (at + 1 < length && data[at + 1] == '"')
+            {
+                toScratch();
+                scratch += '"';
+                field.size++;
+                position = at + 2;
+                next_offset++;
+            }
+            else
+            {
+                in_quotes = false;
+                position = at + 1;
+            }
+            continue;
+        }
+
+        keep(position, at);
+        position = at + 1;
+        if (c == '"')
+        {
+            in_quotes = true;
+        }
+        else if (c == ';')
+        {
+            endField(position);
+        }
+        else if (c == '\n')
+        {
+            row_done = true;
+            break;
+        }
+    }
+
+    // Last row without a trailing newline
+    if (!row_done)
+    {
+        keep(position, length);
+        position = length;
+    }
+    endField(position);
+
+    // Views are taken once scratch has stopped growing
+    fields.clear();
+    for (const Piece &p : pieces)
+    {
+        fields.emplace_back((p.in_scratch ? scratch.data() : data) + p.begin, p.size);
+    }
+    return true;
+}
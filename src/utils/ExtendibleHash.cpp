@@ -0,0 +1,2029 @@
+#include "ExtendibleHash.hpp"
+#include "Buffer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <unordered_set>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace
+{
+    int readInt(const char *ptr)
+    {
+        int value = 0;
+        std::memcpy(&value, ptr, 4);
+        return value;
+    }
+
+    void putInt(std::ostream &out, int value)
+    {
+        out.write(reinterpret_cast<const char *>(&value), 4);
+    }
+
+    int getInt(std::istream &in)
+    {
+        int value = 0;
+        in.read(reinterpret_cast<char *>(&value), 4);
+        return value;
+    }
+
+    void putBucket(std::ostream &out, const HashBucket &bucket)
+    {
+        putInt(out, bucket.block_id);
+        putInt(out, bucket.local_depth);
+        putInt(out, bucket.used_space);
+        putInt(out, bucket.record_count);
+        putInt(out, bucket.overflow_pages);
+        out.write(reinterpret_cast<const char *>(bucket.filter.bits), sizeof(bucket.filter.bits));
+    }
+
+    bool syncPath(const std::string &path)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        bool ok = fd >= 0 && ::fsync(fd) == 0;
+        if (fd >= 0)
+        {
+            ::close(fd);
+        }
+        return ok;
+    }
+
+    std::string directoryOf(const std::string &path)
+    {
+        size_t slash = path.find_last_of('/');
+        return slash == std::string::npos ? "." : path.substr(0, std::max<size_t>(slash, 1));
+    }
+}
+
+// ============== BUCKET PAGE ==============
+
+void BucketPage::format(char *page, int page_size, int local_depth)
+{
+    SlottedPage::format(page, page_size, local_depth);
+}
+
+int BucketPage::getLocalDepth(const char *page, int page_size)
+{
+    return SlottedPage(const_cast<char *>(page), page_size).getAux();
+}
+
+bool BucketPage::append(char *page, int page_size, const char *data, int size)
+{
+    return SlottedPage(page, page_size).insert(data, size) >= 0;
+}
+
+int BucketPage::findSlot(const char *page, int page_size, int id)
+{
+    SlottedPage sp(const_cast<char *>(page), page_size);
+    for (int slot = 0; slot < sp.getSlotCount(); ++slot)
+    {
+        int size = 0;
+        const char *rec = sp.get(slot, size);
+        if (rec && readInt(rec) == id)
+        {
+            return slot;
+        }
+    }
+    return -1;
+}
+
+bool BucketPage::find(const char *page, int page_size, int id, RecordView &out)
+{
+    int slot = findSlot(page, page_size, id);
+    if (slot < 0)
+    {
+        return false;
+    }
+    int size = 0;
+    const char *rec = SlottedPage(const_cast<char *>(page), page_size).get(slot, size);
+    out.reset(rec, size);
+    return true;
+}
+
+bool BucketPage::contains(const char *page, int page_size, int id)
+{
+    return findSlot(page, page_size, id) >= 0;
+}
+
+bool BucketPage::remove(char *page, int page_size, int id)
+{
+    int slot = findSlot(page, page_size, id);
+    return slot >= 0 && SlottedPage(page, page_size).remove(slot);
+}
+
+int BucketPage::getNext(const char *page, int page_size)
+{
+    return SlottedPage(const_cast<char *>(page), page_size).getNext();
+}
+
+void BucketPage::setNext(char *page, int page_size, int page_id)
+{
+    SlottedPage(page, page_size).setNext(page_id);
+}
+
+// ============== EXTENDIBLE HASH ==============
+
+ExtendibleHash::ExtendibleHash(Logger &log, int initial_buckets,
+                               int blk_size, double load_factor)
+    : logger(log), data_file(log, blk_size), global_depth(0), block_size(blk_size),
+      initial_buckets(initial_buckets), max_load_factor(load_factor), split_policy(SplitPolicy::LoadFactor),
+      hash_function(KeyHash::Function::Murmur), max_depth(DEFAULT_MAX_DEPTH), total_records(0), used_bytes(0), read_only(false), failed(false), needs_recovery(false), pinned_block(-1), bulk_loading(false), partition_bits(0),
+      depth_cap_reported(false), wal(log), group_size(DEFAULT_GROUP_SIZE), group_operations(0), applied_lsn(-1),
+      blocks_read(0), blocks_written(0), total_buckets(0), splits_performed(0), merges_performed(0), filter_rejects(0),
+      overflow_pages(0), checkpoints(0) {}
+
+ExtendibleHash::~ExtendibleHash()
+{
+    close();
+}
+
+bool ExtendibleHash::create(const std::string &path)
+{
+    base_path = path;
+    read_only = false;
+    failed = false;
+    // A log or metadata left by the previous file must not be replayed onto this one
+    wal.close();
+    std::remove((base_path + ".wal").c_str());
+    std::remove((base_path + ".meta").c_str());
+    applied_lsn = -1;
+    data_file.setPageSize(block_size);
+    if (!data_file.open(base_path + ".data", true))
+    {
+        return false;
+    }
+
+    // Calculate initial depth
+    global_depth = 0;
+    while ((1 << global_depth) < initial_buckets && global_depth < max_depth)
+    {
+        global_depth++;
+    }
+
+    int num_buckets = 1 << global_depth;
+    page_buffer.assign(block_size, 0);
+    split_buffer.assign(block_size, 0);
+    directory.reset(global_depth, 0);
+    buckets.clear();
+    free_pages.clear();
+
+    // Create buckets, bucket i lives on page i
+    for (int i = 0; i < num_buckets; ++i)
+    {
+        int page_id = data_file.allocatePage();
+        HashBucket &bucket = newBucket(page_id, global_depth);
+        BucketPage::format(page_buffer.data(), block_size, global_depth);
+        writeBucket(bucket, page_buffer.data());
+        directory.set(i, page_id);
+    }
+
+    total_buckets = num_buckets;
+    total_records = 0;
+    used_bytes = 0;
+    overflow_pages = 0;
+
+    std::ostringstream oss;
+    oss << "ExtendibleHash created at " << base_path << " - Global Depth: " << global_depth
+        << " Buckets: " << num_buckets << " Hash: " << KeyHash::name(hash_function)
+        << " Block Size: " << block_size
+        << " bytes Load Factor: " << max_load_factor;
+    LOG_INFO(&logger, oss.str());
+
+    return checkpoint();
+}
+
+bool ExtendibleHash::open(const std::string &path, bool readonly, bool mapped)
+{
+    base_path = path;
+    read_only = readonly;
+    failed = false;
+    needs_recovery = false;
+
+    if (!loadMetadata())
+    {
+        return false;
+    }
+
+    data_file.setPageSize(block_size);
+    if (!data_file.open(base_path + ".data", false, read_only) || !recover())
+    {
+        return false;
+    }
+    // Lookups hit one bucket page each, anywhere in the file
+    if (mapped && read_only)
+    {
+        data_file.map(PageFile::Access::Random);
+    }
+
+    page_buffer.assign(block_size, 0);
+    split_buffer.assign(block_size, 0);
+    if (!read_only && group_size > 0 && !wal.open(base_path + ".wal", applied_lsn + 1))
+    {
+        return false;
+    }
+
+    std::ostringstream oss;
+    oss << "ExtendibleHash opened at " << base_path << " - Global Depth: " << global_depth
+        << " Buckets: " << total_buckets << " Records: " << total_records;
+    LOG_INFO(&logger, oss.str());
+    return true;
+}
+
+void ExtendibleHash::close()
+{
+    if (!data_file.isOpen())
+    {
+        return;
+    }
+    releasePinned();
+    // After a failed commit only the log holds what is durable
+    if (!read_only && !failed)
+    {
+        checkpoint();
+    }
+    wal.close();
+    data_file.close();
+}
+
+int ExtendibleHash::getHashValue(int key, int depth) const
+{
+    if (depth == 0)
+        return 0;
+    int mask = (1 << depth) - 1;
+    return static_cast<int>(KeyHash::hash(hash_function, key)) & mask;
+}
+
+bool ExtendibleHash::parseSplitPolicy(const std::string &name, SplitPolicy &policy)
+{
+    if (name == "overflow")
+        policy = SplitPolicy::Overflow;
+    else if (name == "load")
+        policy = SplitPolicy::LoadFactor;
+    else if (name == "hybrid")
+        policy = SplitPolicy::Hybrid;
+    else
+        return false;
+    return true;
+}
+
+/**
+ * Whether a bucket that just took a record should split ahead of
+ * overflowing; constant time, from the running load statistics
+ */
+bool ExtendibleHash::shouldSplit(const HashBucket &bucket) const
+{
+    switch (split_policy)
+    {
+    case SplitPolicy::LoadFactor:
+        return getLoadFactor() >= max_load_factor;
+    case SplitPolicy::Hybrid:
+        return getLoadFactor() >= max_load_factor && bucket.getOccupancy() >= max_load_factor;
+    default:
+        return false;
+    }
+}
+
+/**
+ * Reset the descriptor of page_id to an empty bucket
+ */
+HashBucket &ExtendibleHash::newBucket(int page_id, int local_depth)
+{
+    while (static_cast<int>(buckets.size()) <= page_id)
+    {
+        int id = buckets.size();
+        buckets.emplace_back(id, 0, id, block_size);
+    }
+    buckets[page_id] = HashBucket(page_id, local_depth, page_id, block_size);
+    return buckets[page_id];
+}
+
+char *ExtendibleHash::pinPage(int block_id)
+{
+    char *page = Buffer::getBuffer()->fetchPage(data_file, block_id);
+    if (page)
+    {
+        blocks_read++;
+    }
+    return page;
+}
+
+void ExtendibleHash::unpinPage(int block_id, bool dirty)
+{
+    if (dirty)
+    {
+        blocks_written++;
+    }
+    // The first change of a page in a group keeps its pin until the
+    // group commits (no-steal)
+    if (dirty && wal.isOpen())
+    {
+        if (static_cast<int>(in_group.size()) <= block_id)
+        {
+            in_group.resize(block_id + 1, false);
+        }
+        if (!in_group[block_id])
+        {
+            in_group[block_id] = true;
+            group_pages.push_back(block_id);
+            return;
+        }
+    }
+    Buffer::getBuffer()->unpinPage(data_file, block_id, dirty);
+}
+
+void ExtendibleHash::releasePinned()
+{
+    if (pinned_block >= 0)
+    {
+        unpinPage(pinned_block, false);
+        pinned_block = -1;
+    }
+}
+
+bool ExtendibleHash::writeBucket(const HashBucket &bucket, const char *page)
+{
+    if (!data_file.writePage(bucket.block_id, page))
+    {
+        return false;
+    }
+    blocks_written++;
+    return true;
+}
+
+bool ExtendibleHash::insert(const char *bytes, int size)
+{
+    bool inserted = insertRecord(bytes, size);
+    bool committed = endOperation();
+    return inserted && committed;
+}
+
+bool ExtendibleHash::insertRecord(const char *bytes, int size)
+{
+    if (read_only)
+    {
+        LOG_ERROR(&logger, "Insert on read-only hash file");
+        return false;
+    }
+    if (failed)
+    {
+        LOG_ERROR(&logger, "Insert refused: an earlier write to " + base_path + " failed");
+        return false;
+    }
+
+    int id = readInt(bytes);
+    if (SlottedPage::footprint(size) > block_size - BucketPage::HEADER_SIZE)
+    {
+        LOG_ERROR(&logger, "Record " + std::to_string(id) + " larger than a block (" +
+                               std::to_string(size) + " bytes)");
+        return false;
+    }
+
+    int hash_val = getHashValue(id, global_depth);
+
+    if (hash_val >= directory.size())
+    {
+        LOG_ERROR(&logger, "Hash value out of bounds");
+        return false;
+    }
+
+    releasePinned();
+    HashBucket &bucket = bucketAt(hash_val);
+    char *page = pinPage(bucket.block_id);
+    if (!page)
+    {
+        return false;
+    }
+
+    // The filter rules out most new IDs without scanning the pages
+    if (bucket.filter.mayContain(id) && chainContains(page, id))
+    {
+        unpinPage(bucket.block_id, false);
+        LOG_WARN(&logger, "Duplicate ID " + std::to_string(id) + " ignored");
+        return false;
+    }
+
+    // Try to insert into bucket; slots left by deletes can still make
+    // the append fail when the descriptor says the record fits
+    if (bucket.overflow_pages == 0 && bucket.fits(size) && BucketPage::append(page, block_size, bytes, size))
+    {
+        unpinPage(bucket.block_id, true);
+        bucket.used_space += SlottedPage::footprint(size);
+        bucket.record_count++;
+        bucket.filter.add(id);
+        total_records++;
+        used_bytes += SlottedPage::footprint(size);
+
+        touchBucket(bucket);
+        logBucketState("INSERT", bucket);
+
+        if (shouldSplit(bucket))
+        {
+            if (bucket.local_depth >= max_depth)
+            {
+                // Reported once: the policy asks again on every insert here
+                if (!depth_cap_reported)
+                {
+                    LOG_INFO(&logger, "Split policy reached the max depth " + std::to_string(max_depth) +
+                                          "; buckets at it keep filling and then chain overflow pages");
+                    depth_cap_reported = true;
+                }
+            }
+            else
+            {
+                LOG_DEBUG(&logger, "Global load factor exceeded. Triggering split.");
+                if (!splitBucket(hash_val))
+                {
+                    LOG_WARN(&logger, "Split of bucket " + std::to_string(hash_val) + " failed");
+                }
+            }
+        }
+
+        // A split that broke off dropped the group holding the record
+        return !failed;
+    }
+    unpinPage(bucket.block_id, false);
+
+    // Bucket full: split while that separates its keys, then chain
+    while (true)
+    {
+        hash_val = getHashValue(id, global_depth);
+        HashBucket &target = bucketAt(hash_val);
+        if (target.overflow_pages == 0 && target.fits(size))
+        {
+            page = pinPage(target.block_id);
+            if (!page)
+            {
+                return false;
+            }
+            bool appended = BucketPage::append(page, block_size, bytes, size);
+            unpinPage(target.block_id, appended);
+            if (appended)
+            {
+                break;
+            }
+        }
+        if (target.local_depth < max_depth && splitSeparates(target, id))
+        {
+            LOG_WARN(&logger, "Bucket " + std::to_string(hash_val) + " full. Splitting.");
+            if (splitBucket(hash_val))
+            {
+                continue;
+            }
+            if (failed)
+            {
+                return false;
+            }
+        }
+
+        page = pinPage(target.block_id);
+        if (!page)
+        {
+            return false;
+        }
+        bool appended = appendToChain(target, page, bytes, size);
+        unpinPage(target.block_id, true);
+        if (!appended)
+        {
+            return false;
+        }
+        break;
+    }
+
+    HashBucket &target = bucketAt(hash_val);
+    target.used_space += SlottedPage::footprint(size);
+    target.record_count++;
+    target.filter.add(id);
+    total_records++;
+    used_bytes += SlottedPage::footprint(size);
+    touchBucket(target);
+    logBucketState("INSERT_AFTER_SPLIT", target);
+    return true;
+}
+
+/**
+ * Whether the bucket whose (pinned) page is given holds id, looking
+ * through its overflow chain too
+ */
+bool ExtendibleHash::chainContains(const char *page, int id)
+{
+    if (BucketPage::contains(page, block_size, id))
+    {
+        return true;
+    }
+    int next = BucketPage::getNext(page, block_size);
+    while (next >= 0)
+    {
+        const char *overflow = pinPage(next);
+        if (!overflow)
+        {
+            return false;
+        }
+        bool found = BucketPage::contains(overflow, block_size, id);
+        int after = BucketPage::getNext(overflow, block_size);
+        unpinPage(next, false);
+        if (found)
+        {
+            return true;
+        }
+        next = after;
+    }
+    return false;
+}
+
+/**
+ * Search a bucket page and its overflow chain, pinning the page found
+ * like fetch does
+ */
+bool ExtendibleHash::findInChain(int block_id, int id, RecordView &out)
+{
+    releasePinned();
+    while (block_id >= 0)
+    {
+        const char *page = pinPage(block_id);
+        if (!page)
+        {
+            return false;
+        }
+        if (BucketPage::find(page, block_size, id, out))
+        {
+            pinned_block = block_id;
+            return true;
+        }
+        int next = BucketPage::getNext(page, block_size);
+        unpinPage(block_id, false);
+        block_id = next;
+    }
+    return false;
+}
+
+/**
+ * Store a record in the first page of the bucket chain with room for
+ * it, linking a new overflow page at the end when none has
+ * The bucket page stays pinned by the caller, who unpins it dirty
+ */
+bool ExtendibleHash::appendToChain(HashBucket &bucket, char *page, const char *bytes, int size)
+{
+    char *current = page;
+    int current_id = bucket.block_id;
+    bool linked = false;
+    while (!BucketPage::append(current, block_size, bytes, size))
+    {
+        int next = BucketPage::getNext(current, block_size);
+        char *next_page = nullptr;
+        if (next < 0)
+        {
+            next = allocateBucketPage();
+            next_page = Buffer::getBuffer()->newPage(data_file, next);
+            if (next_page)
+            {
+                BucketPage::format(next_page, block_size, bucket.local_depth);
+                BucketPage::setNext(current, block_size, next);
+                linked = true;
+                bucket.overflow_pages++;
+                overflow_pages++;
+            }
+        }
+        else
+        {
+            next_page = pinPage(next);
+        }
+
+        if (current != page)
+        {
+            unpinPage(current_id, linked);
+        }
+        if (!next_page)
+        {
+            return false;
+        }
+        current = next_page;
+        current_id = next;
+        linked = false;
+    }
+    if (current != page)
+    {
+        unpinPage(current_id, true);
+    }
+    return true;
+}
+
+/**
+ * Whether splits up to the maximum depth can part the keys of the
+ * bucket and the new id; keys sharing every hash bit up to there
+ * would only leave a trail of empty buckets
+ */
+bool ExtendibleHash::splitSeparates(const HashBucket &bucket, int id)
+{
+    // Hash bits the splits would look at
+    int bits = ((1 << max_depth) - 1) & ~((1 << bucket.local_depth) - 1);
+    int hash = getHashValue(id, max_depth) & bits;
+
+    int page_id = bucket.block_id;
+    while (page_id >= 0)
+    {
+        const char *page = pinPage(page_id);
+        if (!page)
+        {
+            return false;
+        }
+        SlottedPage sp(const_cast<char *>(page), block_size);
+        bool separates = false;
+        for (int slot = 0; slot < sp.getSlotCount() && !separates; ++slot)
+        {
+            int length = 0;
+            const char *rec = sp.get(slot, length);
+            separates = rec && (getHashValue(readInt(rec), max_depth) & bits) != hash;
+        }
+        int next = sp.getNext();
+        unpinPage(page_id, false);
+        if (separates)
+        {
+            return true;
+        }
+        page_id = next;
+    }
+    return false;
+}
+
+bool ExtendibleHash::search(int id, RecordView &out)
+{
+    int hash_val = getHashValue(id, global_depth);
+
+    if (hash_val >= directory.size())
+    {
+        LOG_ERROR(&logger, "Hash value out of bounds");
+        return false;
+    }
+
+    const HashBucket &bucket = bucketAt(hash_val);
+    if (!bucket.filter.mayContain(id))
+    {
+        releasePinned();
+        filter_rejects++;
+        return false;
+    }
+    return findInChain(bucket.block_id, id, out);
+}
+
+void ExtendibleHash::searchBatch(const std::vector<int> &ids, RecordView &out,
+                                 const std::function<void(size_t index, bool found)> &fn)
+{
+    releasePinned();
+
+    // (page, position) pairs sorted by page turn random probes into one
+    // ascending pass over the file
+    std::vector<std::pair<int, size_t>> order;
+    order.reserve(ids.size());
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+        const HashBucket &bucket = bucketAt(getHashValue(ids[i], global_depth));
+        if (bucket.filter.mayContain(ids[i]))
+        {
+            order.emplace_back(bucket.block_id, i);
+        }
+        else
+        {
+            // Answered without a page read, ahead of the page-ordered pass
+            filter_rejects++;
+            fn(i, false);
+        }
+    }
+
+    // Keys missed on a page that has an overflow page move on to it in
+    // the next pass; chains are rare, so most batches take one pass
+    std::vector<std::pair<int, size_t>> next_order;
+    while (!order.empty())
+    {
+        std::sort(order.begin(), order.end());
+        int first = order.front().first;
+        data_file.advise(first, order.back().first - first + 1, PageFile::Access::Sequential);
+
+        next_order.clear();
+        size_t i = 0;
+        while (i < order.size())
+        {
+            int block_id = order[i].first;
+            const char *page = pinPage(block_id);
+            int next = page ? BucketPage::getNext(page, block_size) : -1;
+            for (; i < order.size() && order[i].first == block_id; ++i)
+            {
+                size_t index = order[i].second;
+                if (page && BucketPage::find(page, block_size, ids[index], out))
+                {
+                    fn(index, true);
+                }
+                else if (next >= 0)
+                {
+                    next_order.emplace_back(next, index);
+                }
+                else
+                {
+                    fn(index, false);
+                }
+            }
+            if (page)
+            {
+                unpinPage(block_id, false);
+            }
+        }
+        order.swap(next_order);
+    }
+}
+
+bool ExtendibleHash::remove(int id)
+{
+    bool removed = removeRecord(id);
+    bool committed = endOperation();
+    return removed && committed;
+}
+
+bool ExtendibleHash::removeRecord(int id)
+{
+    if (read_only)
+    {
+        LOG_ERROR(&logger, "Remove on read-only hash file");
+        return false;
+    }
+    if (failed)
+    {
+        LOG_ERROR(&logger, "Remove refused: an earlier write to " + base_path + " failed");
+        return false;
+    }
+
+    releasePinned();
+    int hash_val = getHashValue(id, global_depth);
+    HashBucket &bucket = bucketAt(hash_val);
+    if (!bucket.filter.mayContain(id))
+    {
+        filter_rejects++;
+        return false;
+    }
+    int block_id = bucket.block_id;
+    int prev_id = -1;
+    char *page = pinPage(block_id);
+    if (!page)
+    {
+        return false;
+    }
+
+    int slot;
+    while ((slot = BucketPage::findSlot(page, block_size, id)) < 0)
+    {
+        int next = BucketPage::getNext(page, block_size);
+        unpinPage(block_id, false);
+        if (next < 0)
+        {
+            return false;
+        }
+        prev_id = block_id;
+        block_id = next;
+        page = pinPage(block_id);
+        if (!page)
+        {
+            return false;
+        }
+    }
+
+    SlottedPage sp(page, block_size);
+    int size = 0;
+    sp.get(slot, size);
+    sp.remove(slot);
+
+    // An emptied overflow page is unlinked and freed
+    char *prev = (prev_id >= 0 && sp.getLiveRecords() == 0) ? pinPage(prev_id) : nullptr;
+    if (prev)
+    {
+        BucketPage::setNext(prev, block_size, sp.getNext());
+        BucketPage::format(page, block_size, 0);
+        unpinPage(prev_id, true);
+        freePage(block_id);
+        bucket.overflow_pages--;
+        overflow_pages--;
+    }
+    unpinPage(block_id, true);
+
+    bucket.used_space -= SlottedPage::footprint(size);
+    bucket.record_count--;
+    total_records--;
+    used_bytes -= SlottedPage::footprint(size);
+    touchBucket(bucket);
+    logBucketState("REMOVE", bucket);
+
+    // A merged bucket may in turn merge with its new buddy
+    bool merged = false;
+    while (mergeBucket(hash_val & ((1 << bucketAt(hash_val).local_depth) - 1)))
+    {
+        merged = true;
+    }
+    if (merged)
+    {
+        shrinkDirectory();
+    }
+    return true;
+}
+
+bool ExtendibleHash::fetch(int block_id, int id, RecordView &out)
+{
+    releasePinned();
+    const char *page = pinPage(block_id);
+    if (!page)
+    {
+        return false;
+    }
+    // The frame stays pinned while the caller holds the view
+    pinned_block = block_id;
+    return BucketPage::find(page, block_size, id, out);
+}
+
+bool ExtendibleHash::forEachRecord(const std::function<void(int id, int block_id, const char *data, int size)> &fn)
+{
+    // Pages are read in file order straight from disk, without
+    // evicting the working set from the buffer pool
+    releasePinned();
+    commitGroup();
+    Buffer::getBuffer()->flushFile(data_file);
+    for (int page_id = 0; page_id < data_file.getPageCount(); ++page_id)
+    {
+        if (!data_file.readPage(page_id, page_buffer.data()))
+        {
+            return false;
+        }
+        blocks_read++;
+
+        SlottedPage sp(page_buffer.data(), block_size);
+        for (int slot = 0; slot < sp.getSlotCount(); ++slot)
+        {
+            int size = 0;
+            const char *rec = sp.get(slot, size);
+            if (rec)
+            {
+                fn(readInt(rec), page_id, rec, size);
+            }
+        }
+    }
+    return true;
+}
+
+// ============== BULK LOAD ==============
+
+bool ExtendibleHash::beginBulkLoad(const std::string &path, long long expected_bytes)
+{
+    base_path = path;
+    read_only = false;
+    failed = false;
+    wal.close();
+    std::remove((base_path + ".wal").c_str());
+    std::remove((base_path + ".meta").c_str());
+    applied_lsn = -1;
+    data_file.setPageSize(block_size);
+    if (!data_file.open(base_path + ".data", true))
+    {
+        return false;
+    }
+
+    // Final depth: enough buckets to hold the estimate at the target load
+    long long usable = static_cast<long long>((block_size - BucketPage::HEADER_SIZE) * max_load_factor);
+    long long buckets_needed = std::max(1LL, expected_bytes / std::max(1LL, usable) + 1);
+    global_depth = 0;
+    while ((1LL << global_depth) < std::max<long long>(buckets_needed, initial_buckets) &&
+           global_depth < max_depth)
+    {
+        global_depth++;
+    }
+
+    // Partitions cover contiguous ranges of bucket indexes (high bits)
+    partition_bits = std::min(global_depth, 8);
+    partitions.clear();
+    for (int p = 0; p < (1 << partition_bits); ++p)
+    {
+        partitions.emplace_back(partitionPath(p), std::ios::binary | std::ios::trunc);
+        if (!partitions.back().is_open())
+        {
+            LOG_ERROR(&logger, "Could not create bulk load partition: " + partitionPath(p));
+            partitions.clear();
+            return false;
+        }
+    }
+
+    page_buffer.assign(block_size, 0);
+    split_buffer.assign(block_size, 0);
+    directory.reset(global_depth, 0);
+    buckets.clear();
+    free_pages.clear();
+    total_records = 0;
+    used_bytes = 0;
+    overflow_pages = 0;
+    total_buckets = 0;
+    bulk_loading = true;
+
+    std::ostringstream oss;
+    oss << "Bulk load started at " << base_path << " - Expected Bytes: " << expected_bytes
+        << " Global Depth: " << global_depth << " Partitions: " << partitions.size();
+    LOG_INFO(&logger, oss.str());
+    return true;
+}
+
+bool ExtendibleHash::bulkAdd(const char *bytes, int size)
+{
+    if (!bulk_loading)
+    {
+        LOG_ERROR(&logger, "bulkAdd called outside of a bulk load");
+        return false;
+    }
+
+    int id = readInt(bytes);
+    if (SlottedPage::footprint(size) > block_size - BucketPage::HEADER_SIZE)
+    {
+        LOG_ERROR(&logger, "Record " + std::to_string(id) + " larger than a block (" +
+                               std::to_string(size) + " bytes)");
+        return false;
+    }
+
+    int bucket_index = getHashValue(id, global_depth);
+    int partition = bucket_index >> (global_depth - partition_bits);
+    partitions[partition].write(bytes, size);
+    return static_cast<bool>(partitions[partition]);
+}
+
+std::string ExtendibleHash::partitionPath(int partition) const
+{
+    return base_path + ".part" + std::to_string(partition);
+}
+
+/**
+ * Pack one partition into its bucket pages, appended in file order
+ * Records that overflow their bucket go to overflow pages written right
+ * after it, so skewed buckets cost no more than the others
+ */
+bool ExtendibleHash::loadPartition(int partition)
+{
+    std::ifstream in(partitionPath(partition), std::ios::binary | std::ios::ate);
+    if (!in.is_open())
+    {
+        LOG_ERROR(&logger, "Could not reopen bulk load partition: " + partitionPath(partition));
+        return false;
+    }
+    std::vector<char> data(static_cast<size_t>(in.tellg()));
+    in.seekg(0);
+    in.read(data.data(), data.size());
+    in.close();
+    std::remove(partitionPath(partition).c_str());
+
+    // (bucket index, offset) sorted by bucket, input order kept inside a bucket
+    std::vector<std::pair<int, int>> entries;
+    for (size_t offset = 0; offset + 12 <= data.size();)
+    {
+        int id = readInt(data.data() + offset);
+        int size = readInt(data.data() + offset + 8);
+        entries.emplace_back(getHashValue(id, global_depth), static_cast<int>(offset));
+        offset += size;
+    }
+    std::stable_sort(entries.begin(), entries.end(),
+                     [](const std::pair<int, int> &a, const std::pair<int, int> &b)
+                     { return a.first < b.first; });
+
+    int buckets_per_partition = 1 << (global_depth - partition_bits);
+    int first = partition * buckets_per_partition;
+    size_t next = 0;
+    std::unordered_set<int> seen;
+    for (int b = first; b < first + buckets_per_partition; ++b)
+    {
+        int page_id = data_file.allocatePage();
+        HashBucket &bucket = newBucket(page_id, global_depth);
+        BucketPage::format(page_buffer.data(), block_size, global_depth);
+        int tail_id = page_id;
+
+        // The first copy of an ID wins, as with insert
+        seen.clear();
+        for (; next < entries.size() && entries[next].first == b; ++next)
+        {
+            const char *rec = data.data() + entries[next].second;
+            int id = readInt(rec);
+            int size = readInt(rec + 8);
+
+            if (!seen.insert(id).second)
+            {
+                LOG_WARN(&logger, "Duplicate ID " + std::to_string(id) + " ignored");
+                continue;
+            }
+            if (!BucketPage::append(page_buffer.data(), block_size, rec, size))
+            {
+                int overflow_id = data_file.allocatePage();
+                BucketPage::setNext(page_buffer.data(), block_size, overflow_id);
+                if (!data_file.writePage(tail_id, page_buffer.data()))
+                {
+                    return false;
+                }
+                blocks_written++;
+                BucketPage::format(page_buffer.data(), block_size, global_depth);
+                BucketPage::append(page_buffer.data(), block_size, rec, size);
+                tail_id = overflow_id;
+                bucket.overflow_pages++;
+                overflow_pages++;
+            }
+            bucket.used_space += SlottedPage::footprint(size);
+            bucket.record_count++;
+            bucket.filter.add(id);
+        }
+
+        if (!data_file.writePage(tail_id, page_buffer.data()))
+        {
+            return false;
+        }
+        blocks_written++;
+        total_records += bucket.record_count;
+        used_bytes += bucket.used_space;
+        directory.set(b, page_id);
+    }
+    return true;
+}
+
+bool ExtendibleHash::endBulkLoad()
+{
+    if (!bulk_loading)
+    {
+        return false;
+    }
+    bulk_loading = false;
+
+    for (auto &part : partitions)
+    {
+        part.close();
+    }
+
+    bool ok = true;
+    for (int p = 0; p < static_cast<int>(partitions.size()); ++p)
+    {
+        ok = ok && loadPartition(p);
+        if (!ok)
+        {
+            std::remove(partitionPath(p).c_str());
+        }
+    }
+    partitions.clear();
+    total_buckets = directory.size();
+
+    if (!ok)
+    {
+        LOG_ERROR(&logger, "Bulk load failed while writing bucket pages");
+        return false;
+    }
+
+    std::ostringstream oss;
+    oss << "Bulk load wrote " << total_buckets << " buckets sequentially, "
+        << total_records << " records, " << overflow_pages << " overflow pages";
+    LOG_INFO(&logger, oss.str());
+
+    return checkpoint();
+}
+
+/**
+ * Split a bucket in place: only the records of the smaller side move, to
+ * a new bucket, and chain pages that keep all their records stay as they
+ * are. The chain is read before anything changes, so a page that cannot
+ * be read leaves the bucket untouched
+ * @return false if the bucket was not split; hasFailed tells a refused
+ *         or unreadable split from one that broke off half way
+ */
+bool ExtendibleHash::splitBucket(int bucket_index)
+{
+    HashBucket &bucket = bucketAt(bucket_index);
+    int new_depth = bucket.local_depth + 1;
+    int high_bit = 1 << (new_depth - 1);
+
+    // Chain pages in order and the records of each side in them
+    std::vector<int> chain;
+    std::vector<int> side_records[2];
+    std::vector<int> side_ids[2];
+    long long side_bytes[2] = {0, 0};
+    for (int next = bucket.block_id; next >= 0;)
+    {
+        const char *page = pinPage(next);
+        if (!page)
+        {
+            return false;
+        }
+        chain.push_back(next);
+        side_records[0].push_back(0);
+        side_records[1].push_back(0);
+        SlottedPage sp(const_cast<char *>(page), block_size);
+        for (int slot = 0; slot < sp.getSlotCount(); ++slot)
+        {
+            int size = 0;
+            const char *rec = sp.get(slot, size);
+            if (rec)
+            {
+                int id = readInt(rec);
+                int side = (getHashValue(id, new_depth) & high_bit) ? 1 : 0;
+                side_records[side].back()++;
+                side_ids[side].push_back(id);
+                side_bytes[side] += SlottedPage::footprint(size);
+            }
+        }
+        int after = sp.getNext();
+        unpinPage(next, false);
+        next = after;
+    }
+
+    // The smaller side moves; the other keeps the page and its chain
+    int move = side_bytes[1] <= side_bytes[0] ? 1 : 0;
+    int stay = 1 - move;
+
+    // Pages the split dirties: the bucket page, chain pages that lose
+    // records (and the page before one that empties), and the new chain,
+    // which packs at least one page's worth into every two pages
+    long long cost = 2 + 2 * side_bytes[move] / bucket.getCapacity();
+    for (size_t i = 1; i < chain.size(); ++i)
+    {
+        if (side_records[move][i] > 0)
+        {
+            cost += side_records[stay][i] > 0 ? 1 : 2;
+        }
+    }
+    // Every page of a group stays pinned until it commits; a split that
+    // alone would hold half the pool leaves the record to the chain
+    if (wal.isOpen())
+    {
+        if (static_cast<int>(group_pages.size()) + cost > holdLimit() && !commitGroup())
+        {
+            return false;
+        }
+        if (cost > Buffer::getBuffer()->getFrameCount() / 2)
+        {
+            LOG_DEBUG(&logger, "Split of bucket page " + std::to_string(bucket.block_id) + " would hold " +
+                                   std::to_string(cost) + " pages; chaining instead");
+            return false;
+        }
+    }
+
+    if (bucket.local_depth == global_depth)
+    {
+        doubleDirectory();
+    }
+
+    // New bucket on a free page or at the end of the file
+    int page_id = allocateBucketPage();
+    HashBucket &new_bucket = newBucket(page_id, new_depth);
+    int tail_id = page_id;
+    char *tail = Buffer::getBuffer()->newPage(data_file, page_id);
+    if (!tail)
+    {
+        return abortSplit(bucket);
+    }
+    BucketPage::format(tail, block_size, new_depth);
+
+    int prev_id = -1;
+    for (size_t i = 0; i < chain.size(); ++i)
+    {
+        if (i > 0 && side_records[move][i] == 0)
+        {
+            prev_id = chain[i];
+            continue;
+        }
+        char *page = pinPage(chain[i]);
+        if (!page)
+        {
+            unpinPage(tail_id, true);
+            return abortSplit(bucket);
+        }
+        SlottedPage sp(page, block_size);
+        if (i == 0)
+        {
+            sp.setAux(new_depth);
+        }
+        for (int slot = 0; slot < sp.getSlotCount(); ++slot)
+        {
+            int size = 0;
+            const char *rec = sp.get(slot, size);
+            if (!rec || ((getHashValue(readInt(rec), new_depth) & high_bit) ? 1 : 0) != move)
+            {
+                continue;
+            }
+            // Next fit: a full tail gets a new overflow page linked after it
+            while (!BucketPage::append(tail, block_size, rec, size))
+            {
+                int next = allocateBucketPage();
+                char *next_page = Buffer::getBuffer()->newPage(data_file, next);
+                if (!next_page)
+                {
+                    unpinPage(tail_id, true);
+                    unpinPage(chain[i], true);
+                    return abortSplit(bucket);
+                }
+                BucketPage::format(next_page, block_size, new_depth);
+                BucketPage::setNext(tail, block_size, next);
+                unpinPage(tail_id, true);
+                tail = next_page;
+                tail_id = next;
+                new_bucket.overflow_pages++;
+                overflow_pages++;
+            }
+            sp.remove(slot);
+        }
+
+        // An overflow page left empty leaves the chain and is freed
+        if (i > 0 && sp.getLiveRecords() == 0)
+        {
+            char *prev = pinPage(prev_id);
+            if (!prev)
+            {
+                unpinPage(chain[i], true);
+                unpinPage(tail_id, true);
+                return abortSplit(bucket);
+            }
+            BucketPage::setNext(prev, block_size, sp.getNext());
+            unpinPage(prev_id, true);
+            BucketPage::format(page, block_size, 0);
+            unpinPage(chain[i], true);
+            freePage(chain[i]);
+            bucket.overflow_pages--;
+            overflow_pages--;
+            continue;
+        }
+        unpinPage(chain[i], true);
+        prev_id = chain[i];
+    }
+    unpinPage(tail_id, true);
+
+    // Descriptors: the filters are rebuilt, which also drops removed IDs
+    bucket.local_depth = new_depth;
+    bucket.used_space -= static_cast<int>(side_bytes[move]);
+    bucket.record_count -= static_cast<int>(side_ids[move].size());
+    bucket.filter.clear();
+    for (int id : side_ids[stay])
+    {
+        bucket.filter.add(id);
+    }
+    new_bucket.used_space = static_cast<int>(side_bytes[move]);
+    new_bucket.record_count = static_cast<int>(side_ids[move].size());
+    for (int id : side_ids[move])
+    {
+        new_bucket.filter.add(id);
+    }
+
+    // Every directory slot sharing the old suffix with the moved side's
+    // bit now points to the new bucket
+    int suffix = bucket_index & (high_bit - 1);
+    pointSuffix(move ? (suffix | high_bit) : suffix, new_depth, page_id);
+    touchBucket(bucket);
+    touchBucket(new_bucket);
+
+    total_buckets++;
+    splits_performed++;
+
+    logBucketState("SPLIT_OLD", bucket);
+    logBucketState("SPLIT_NEW", new_bucket);
+    return true;
+}
+
+/**
+ * A page of a split in progress could not be pinned: its pages are half
+ * rewritten, so the open group is dropped and the file takes no more writes
+ */
+bool ExtendibleHash::abortSplit(const HashBucket &bucket)
+{
+    LOG_ERROR(&logger, "Split of bucket page " + std::to_string(bucket.block_id) +
+                           " broke off: a page could not be pinned");
+    dropGroup();
+    return false;
+}
+
+/**
+ * Take the free pages that end the data file off the free list
+ * @return page count of the file without them
+ */
+int ExtendibleHash::trailingFreePages()
+{
+    int pages = data_file.getPageCount();
+    std::sort(free_pages.begin(), free_pages.end());
+    while (!free_pages.empty() && free_pages.back() == pages - 1)
+    {
+        free_pages.pop_back();
+        pages--;
+    }
+    return pages;
+}
+
+int ExtendibleHash::allocateBucketPage()
+{
+    if (free_pages.empty())
+    {
+        return data_file.allocatePage();
+    }
+    int page_id = free_pages.back();
+    free_pages.pop_back();
+    logChange(FREE_POP);
+    return page_id;
+}
+
+/**
+ * Merge the bucket at directory index bucket_index (its local depth
+ * suffix) with its buddy, the bucket differing in the top suffix bit
+ * @return true if the buckets were merged
+ */
+bool ExtendibleHash::mergeBucket(int bucket_index)
+{
+    HashBucket &bucket = bucketAt(bucket_index);
+    int depth = bucket.local_depth;
+    if (depth == 0)
+    {
+        return false;
+    }
+    int high_bit = 1 << (depth - 1);
+    HashBucket &buddy = bucketAt(bucket_index ^ high_bit);
+    if (&buddy == &bucket || buddy.local_depth != depth ||
+        bucket.overflow_pages > 0 || buddy.overflow_pages > 0 ||
+        bucket.used_space + buddy.used_space > bucket.getCapacity() * MERGE_THRESHOLD)
+    {
+        return false;
+    }
+
+    // The bucket without the high bit survives and takes the records
+    HashBucket &keep = (bucket_index & high_bit) ? buddy : bucket;
+    HashBucket &gone = (bucket_index & high_bit) ? bucket : buddy;
+    char *keep_page = pinPage(keep.block_id);
+    if (!keep_page)
+    {
+        return false;
+    }
+    char *gone_page = pinPage(gone.block_id);
+    if (!gone_page)
+    {
+        unpinPage(keep.block_id, false);
+        return false;
+    }
+
+    // Records move into a scratch copy, so a record that does not fit
+    // (used space out of step with the page) leaves both pages as they were
+    std::memcpy(split_buffer.data(), keep_page, block_size);
+    SlottedPage gone_sp(gone_page, block_size);
+    for (int slot = 0; slot < gone_sp.getSlotCount(); ++slot)
+    {
+        int size = 0;
+        const char *rec = gone_sp.get(slot, size);
+        if (rec && !BucketPage::append(split_buffer.data(), block_size, rec, size))
+        {
+            unpinPage(keep.block_id, false);
+            unpinPage(gone.block_id, false);
+            LOG_WARN(&logger, "Merge into bucket page " + std::to_string(keep.block_id) +
+                                  " aborted: records of page " + std::to_string(gone.block_id) + " do not fit");
+            return false;
+        }
+    }
+    std::memcpy(keep_page, split_buffer.data(), block_size);
+    SlottedPage(keep_page, block_size).setAux(depth - 1);
+    // Emptied so file scans skip the free page
+    BucketPage::format(gone_page, block_size, 0);
+    unpinPage(keep.block_id, true);
+    unpinPage(gone.block_id, true);
+
+    keep.local_depth = depth - 1;
+    keep.used_space += gone.used_space;
+    keep.record_count += gone.record_count;
+    keep.filter.merge(gone.filter);
+
+    // Slots of the merged bucket share its suffix, every 2^depth entries
+    pointSuffix((bucket_index & (high_bit - 1)) | high_bit, depth, keep.block_id);
+    freePage(gone.block_id);
+    touchBucket(keep);
+    total_buckets--;
+    merges_performed++;
+
+    logBucketState("MERGE", keep);
+    return true;
+}
+
+void ExtendibleHash::shrinkDirectory()
+{
+    while (global_depth > 0)
+    {
+        // The top half mirrors the bottom half once no bucket needs the
+        // full global depth
+        for (int i = 0; i < directory.size(); ++i)
+        {
+            if (bucketAt(i).local_depth == global_depth)
+            {
+                return;
+            }
+        }
+        directory.shrink();
+        global_depth--;
+        logChange(DIRECTORY_SHRINK);
+
+        std::ostringstream oss;
+        oss << "Directory halved - New Global Depth: " << global_depth
+            << " New Size: " << directory.size();
+        LOG_INFO(&logger, oss.str());
+    }
+}
+
+void ExtendibleHash::doubleDirectory()
+{
+    // The new upper half mirrors the lower one without being copied
+    directory.grow();
+    global_depth++;
+    logChange(DIRECTORY_GROW);
+
+    std::ostringstream oss;
+    oss << "Directory doubled - New Global Depth: " << global_depth
+        << " New Size: " << directory.size();
+    LOG_INFO(&logger, oss.str());
+}
+
+// ============== WRITE-AHEAD LOG ==============
+
+/**
+ * Count a finished insert or remove toward the open group
+ * Groups only end between operations, so the log never holds half a split
+ */
+bool ExtendibleHash::endOperation()
+{
+    if (!wal.isOpen())
+    {
+        return true;
+    }
+    // Held pages cannot be evicted; commit before they crowd the pool
+    if (++group_operations >= group_size || static_cast<int>(group_pages.size()) >= holdLimit())
+    {
+        if (!commitGroup())
+        {
+            return false;
+        }
+        long long data_bytes = static_cast<long long>(data_file.getPageCount()) * block_size;
+        if (wal.getSize() >= std::max(CHECKPOINT_MIN_BYTES, data_bytes))
+        {
+            return checkpoint();
+        }
+    }
+    return true;
+}
+
+int ExtendibleHash::holdLimit() const
+{
+    return std::max(1, Buffer::getBuffer()->getFrameCount() / 4);
+}
+
+void ExtendibleHash::touchBucket(const HashBucket &bucket)
+{
+    if (!wal.isOpen())
+    {
+        return;
+    }
+    if (static_cast<int>(bucket_in_group.size()) <= bucket.block_id)
+    {
+        bucket_in_group.resize(bucket.block_id + 1, false);
+    }
+    if (!bucket_in_group[bucket.block_id])
+    {
+        bucket_in_group[bucket.block_id] = true;
+        group_buckets.push_back(bucket.block_id);
+    }
+}
+
+void ExtendibleHash::logChange(ChangeOp op, int page_id, int suffix, int depth)
+{
+    if (wal.isOpen())
+    {
+        group_changes.push_back({op, page_id, suffix, depth});
+    }
+}
+
+/**
+ * Point every directory entry whose low depth bits are suffix to page_id
+ */
+void ExtendibleHash::pointSuffix(int suffix, int depth, int page_id)
+{
+    for (int i = suffix; i < directory.size(); i += (1 << depth))
+    {
+        directory.set(i, page_id);
+    }
+    logChange(POINT_SUFFIX, page_id, suffix, depth);
+}
+
+void ExtendibleHash::freePage(int page_id)
+{
+    free_pages.push_back(page_id);
+    logChange(FREE_PUSH, page_id);
+}
+
+/**
+ * Log the images of the pages the open group changed and its other
+ * changes, sync once, then let the Buffer pool write the pages back
+ *
+ * Commit payload:
+ * [Total Records][Total Buckets]
+ * [Descriptor Count] x [Block ID][Local Depth][Used Space][Record Count][Overflow Pages][Filter: 64]
+ * [Change Count] x [Op][Page ID][Suffix][Depth]
+ */
+bool ExtendibleHash::commitGroup()
+{
+    group_operations = 0;
+    if (failed)
+    {
+        return false;
+    }
+    if (!wal.isOpen() || group_pages.empty())
+    {
+        return true;
+    }
+
+    Buffer *buffer = Buffer::getBuffer();
+    std::sort(group_pages.begin(), group_pages.end());
+    bool ok = true;
+    for (int page_id : group_pages)
+    {
+        // Still pinned by the group, so always a hit
+        const char *page = buffer->fetchPage(data_file, page_id);
+        if (!page)
+        {
+            ok = false;
+            continue;
+        }
+        wal.logPage(page_id, page, block_size);
+        buffer->unpinPage(data_file, page_id, false);
+    }
+
+    std::ostringstream changes;
+    putInt(changes, total_records);
+    putInt(changes, total_buckets);
+    putInt(changes, static_cast<int>(group_buckets.size()));
+    for (int page_id : group_buckets)
+    {
+        putBucket(changes, buckets[page_id]);
+        bucket_in_group[page_id] = false;
+    }
+    putInt(changes, static_cast<int>(group_changes.size()));
+    for (const MetaChange &change : group_changes)
+    {
+        putInt(changes, change.op);
+        putInt(changes, change.page_id);
+        putInt(changes, change.suffix);
+        putInt(changes, change.depth);
+    }
+    if (!wal.commit(changes.str()) || !ok)
+    {
+        LOG_ERROR(&logger, "Group commit failed for " + base_path + ".wal; its changes are dropped "
+                           "and the hash file takes no more writes");
+        dropGroup();
+        return false;
+    }
+    applied_lsn = wal.getLastLsn();
+
+    for (int page_id : group_pages)
+    {
+        buffer->unpinPage(data_file, page_id, true);
+        in_group[page_id] = false;
+    }
+    group_pages.clear();
+    group_buckets.clear();
+    group_changes.clear();
+    return true;
+}
+
+/**
+ * Forget the open group after a failure: its pages leave the Buffer pool
+ * unwritten (no-steal) and the file takes no more writes; the next
+ * read-write open rebuilds it from .meta and the groups the log kept
+ */
+void ExtendibleHash::dropGroup()
+{
+    for (int page_id : group_pages)
+    {
+        Buffer::getBuffer()->discardPage(data_file, page_id);
+        in_group[page_id] = false;
+    }
+    for (int page_id : group_buckets)
+    {
+        bucket_in_group[page_id] = false;
+    }
+    group_pages.clear();
+    group_buckets.clear();
+    group_changes.clear();
+    failed = true;
+}
+
+bool ExtendibleHash::checkpoint()
+{
+    if (read_only || failed || bulk_loading || !data_file.isOpen())
+    {
+        return false;
+    }
+    releasePinned();
+    // The open group is logged first: the Buffer pool may write its
+    // pages out before .meta is replaced
+    bool ok = commitGroup() && Buffer::getBuffer()->flushFile(data_file) && data_file.sync();
+
+    // Free pages at the end of the file leave it once .meta no longer
+    // lists them; the log is empty after this, so no logged change of
+    // the free list refers to them
+    std::vector<int> listed = free_pages;
+    int pages = ok ? trailingFreePages() : data_file.getPageCount();
+    ok = ok && saveMetadata();
+    if (!ok)
+    {
+        free_pages.swap(listed);
+    }
+    else if (pages < data_file.getPageCount())
+    {
+        LOG_INFO(&logger, "Data file shrunk from " + std::to_string(data_file.getPageCount()) + " to " +
+                              std::to_string(pages) + " pages");
+        data_file.truncate(pages);
+    }
+    if (ok && group_size > 0)
+    {
+        ok = wal.isOpen() ? wal.truncate() : wal.open(base_path + ".wal", applied_lsn + 1);
+    }
+    if (!ok)
+    {
+        LOG_ERROR(&logger, "Checkpoint failed for " + base_path);
+        return false;
+    }
+    checkpoints++;
+    return true;
+}
+
+/**
+ * Redo one committed group over the metadata (see commitGroup)
+ */
+bool ExtendibleHash::applyChanges(const char *data, int size)
+{
+    std::istringstream in(std::string(data, size));
+    total_records = getInt(in);
+    total_buckets = getInt(in);
+    int descriptors = getInt(in);
+    for (int i = 0; i < descriptors && in; ++i)
+    {
+        if (!readBucket(in))
+        {
+            return false;
+        }
+    }
+
+    int count = getInt(in);
+    for (int i = 0; i < count && in; ++i)
+    {
+        int op = getInt(in);
+        int page_id = getInt(in);
+        int suffix = getInt(in);
+        int depth = getInt(in);
+        switch (op)
+        {
+        case POINT_SUFFIX:
+            if (page_id < 0 || page_id >= static_cast<int>(buckets.size()) ||
+                depth < 1 || depth > global_depth || suffix < 0 || suffix >= (1 << depth))
+            {
+                return false;
+            }
+            for (int e = suffix; e < directory.size(); e += (1 << depth))
+            {
+                directory.set(e, page_id);
+            }
+            break;
+        case DIRECTORY_GROW:
+            directory.grow();
+            global_depth++;
+            break;
+        case DIRECTORY_SHRINK:
+            directory.shrink();
+            global_depth--;
+            break;
+        case FREE_PUSH:
+            free_pages.push_back(page_id);
+            break;
+        case FREE_POP:
+            if (free_pages.empty())
+            {
+                return false;
+            }
+            free_pages.pop_back();
+            break;
+        default:
+            return false;
+        }
+    }
+    return static_cast<bool>(in);
+}
+
+/**
+ * Redo the groups committed after the metadata of the last checkpoint:
+ * their page images go into the data file and their other changes over
+ * the loaded metadata, which then replaces .meta. Groups at or below the
+ * LSN in .meta are skipped, so a crash during recovery only repeats it
+ */
+bool ExtendibleHash::recover()
+{
+    std::string log_path = base_path + ".wal";
+    if (read_only)
+    {
+        // Readers never write the store; a log with committed groups
+        // must be replayed by a read-write open first
+        int pending = WriteAheadLog::replay(
+            logger, log_path, applied_lsn,
+            [](int, const char *, int)
+            { return true; },
+            [](long long, const char *, int)
+            { return true; });
+        if (pending > 0)
+        {
+            needs_recovery = true;
+            LOG_ERROR(&logger, base_path + " has " + std::to_string(pending) +
+                                   " committed groups in its write-ahead log; open it read-write "
+                                   "(delrec --recover) to replay them");
+            return false;
+        }
+        return true;
+    }
+
+    int groups = WriteAheadLog::replay(
+        logger, log_path, applied_lsn,
+        [&](int page_id, const char *data, int size)
+        {
+            return size == block_size && data_file.writePage(page_id, data);
+        },
+        [&](long long lsn, const char *data, int size)
+        {
+            applied_lsn = lsn;
+            return applyChanges(data, size);
+        });
+    if (groups < 0)
+    {
+        needs_recovery = true;
+        LOG_ERROR(&logger, "Recovery failed replaying " + log_path);
+        return false;
+    }
+    if (groups == 0)
+    {
+        return true;
+    }
+
+    // Load totals follow from the live buckets
+    used_bytes = 0;
+    overflow_pages = 0;
+    std::vector<bool> seen(buckets.size(), false);
+    for (int i = 0; i < directory.size(); ++i)
+    {
+        int page_id = directory.get(i);
+        if (!seen[page_id])
+        {
+            seen[page_id] = true;
+            used_bytes += buckets[page_id].used_space;
+            overflow_pages += buckets[page_id].overflow_pages;
+        }
+    }
+
+    if (!data_file.sync() || !saveMetadata())
+    {
+        needs_recovery = true;
+        return false;
+    }
+    std::remove(log_path.c_str());
+
+    std::ostringstream oss;
+    oss << "Recovered " << base_path << " - Replayed " << groups << " committed groups from " << log_path;
+    LOG_INFO(&logger, oss.str());
+    return true;
+}
+
+// ============== METADATA ==============
+
+/**
+ * Metadata layout:
+ * [Magic][Version][Block Size][Global Depth][Total Buckets][Total Records][Page Count]
+ * [Hash Function][Log LSN: 8]
+ * Total Buckets x [Block ID][Local Depth][Used Space][Record Count][Overflow Pages][Filter: 64]
+ * 2^Global Depth x [Block ID]
+ * [Free Page Count] then Free Page Count x [Page ID]
+ *
+ * Written to a temporary file, synced and renamed over .meta, so a
+ * crash leaves either the old or the new metadata
+ */
+bool ExtendibleHash::saveMetadata()
+{
+    // Live buckets in directory order
+    std::vector<const HashBucket *> live;
+    std::vector<bool> seen(buckets.size(), false);
+    for (int i = 0; i < directory.size(); ++i)
+    {
+        int page_id = directory.get(i);
+        if (!seen[page_id])
+        {
+            seen[page_id] = true;
+            live.push_back(&buckets[page_id]);
+        }
+    }
+
+    std::string meta_path = base_path + ".meta";
+    std::string temp_path = meta_path + ".tmp";
+    std::ofstream meta(temp_path, std::ios::binary | std::ios::trunc);
+    if (!meta.is_open())
+    {
+        LOG_ERROR(&logger, "Could not write hash metadata: " + temp_path);
+        return false;
+    }
+
+    putInt(meta, META_MAGIC);
+    putInt(meta, META_VERSION);
+    putInt(meta, block_size);
+    putInt(meta, global_depth);
+    putInt(meta, static_cast<int>(live.size()));
+    putInt(meta, total_records);
+    putInt(meta, data_file.getPageCount());
+    putInt(meta, static_cast<int>(hash_function));
+    meta.write(reinterpret_cast<const char *>(&applied_lsn), sizeof(applied_lsn));
+
+    for (const auto *b : live)
+    {
+        putBucket(meta, *b);
+    }
+    for (int i = 0; i < directory.size(); ++i)
+    {
+        putInt(meta, directory.get(i));
+    }
+    putInt(meta, static_cast<int>(free_pages.size()));
+    for (int page_id : free_pages)
+    {
+        putInt(meta, page_id);
+    }
+
+    meta.close();
+    if (!meta || !syncPath(temp_path) || std::rename(temp_path.c_str(), meta_path.c_str()) != 0 ||
+        !syncPath(directoryOf(meta_path)))
+    {
+        LOG_ERROR(&logger, "Could not write hash metadata: " + meta_path);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Descriptor as written by putBucket, replacing the one of its page
+ * @return nullptr on a truncated stream or an invalid page id
+ */
+HashBucket *ExtendibleHash::readBucket(std::istream &in)
+{
+    int block_id = getInt(in);
+    int local_depth = getInt(in);
+    if (!in || block_id < 0)
+    {
+        LOG_ERROR(&logger, "Invalid bucket page in hash metadata of " + base_path);
+        return nullptr;
+    }
+    HashBucket &bucket = newBucket(block_id, local_depth);
+    bucket.used_space = getInt(in);
+    bucket.record_count = getInt(in);
+    bucket.overflow_pages = getInt(in);
+    in.read(reinterpret_cast<char *>(bucket.filter.bits), sizeof(bucket.filter.bits));
+    return &bucket;
+}
+
+bool ExtendibleHash::loadMetadata()
+{
+    std::ifstream meta(base_path + ".meta", std::ios::binary);
+    if (!meta.is_open())
+    {
+        LOG_ERROR(&logger, "Could not open hash metadata: " + base_path + ".meta");
+        return false;
+    }
+
+    if (getInt(meta) != META_MAGIC || getInt(meta) != META_VERSION)
+    {
+        LOG_ERROR(&logger, "Invalid hash metadata: " + base_path + ".meta");
+        return false;
+    }
+
+    block_size = getInt(meta);
+    global_depth = getInt(meta);
+    total_buckets = getInt(meta);
+    total_records = getInt(meta);
+    getInt(meta); // page count, recomputed from the data file size
+    int function = getInt(meta);
+    if (function < static_cast<int>(KeyHash::Function::Identity) ||
+        function > static_cast<int>(KeyHash::Function::Crc32c))
+    {
+        LOG_ERROR(&logger, "Unknown hash function in " + base_path + ".meta");
+        return false;
+    }
+    hash_function = static_cast<KeyHash::Function>(function);
+    meta.read(reinterpret_cast<char *>(&applied_lsn), sizeof(applied_lsn));
+
+    buckets.clear();
+    used_bytes = 0;
+    overflow_pages = 0;
+    std::vector<bool> known;
+    for (int i = 0; i < total_buckets && meta; ++i)
+    {
+        HashBucket *bucket = readBucket(meta);
+        if (!bucket)
+        {
+            return false;
+        }
+        used_bytes += bucket->used_space;
+        overflow_pages += bucket->overflow_pages;
+        known.resize(std::max<size_t>(known.size(), bucket->block_id + 1), false);
+        known[bucket->block_id] = true;
+    }
+
+    directory.reset(global_depth, 0);
+    for (int i = 0; i < directory.size(); ++i)
+    {
+        int page_id = getInt(meta);
+        if (page_id < 0 || page_id >= static_cast<int>(known.size()) || !known[page_id])
+        {
+            LOG_ERROR(&logger, "Directory references unknown bucket in " + base_path + ".meta");
+            return false;
+        }
+        directory.set(i, page_id);
+    }
+
+    free_pages.resize(std::max(0, getInt(meta)));
+    for (int &page_id : free_pages)
+    {
+        page_id = getInt(meta);
+    }
+
+    if (!meta)
+    {
+        LOG_ERROR(&logger, "Truncated hash metadata: " + base_path + ".meta");
+        return false;
+    }
+    return true;
+}
+
+void ExtendibleHash::logBucketState(const std::string &op,
+                                    const HashBucket &bucket)
+{
+    std::ostringstream oss;
+    oss << "BucketOp[" << op << "] " << bucket.toString();
+    LOG_DEBUG(&logger, oss.str());
+}
+
+void ExtendibleHash::printStructure() const
+{
+    std::ostringstream oss;
+    oss << "\n=== EXTENDIBLE HASH STRUCTURE V2 ===\n"
+        << "Global Depth: " << global_depth << "\n"
+        << "Directory Size: " << directory.size() << "\n"
+        << "Total Buckets: " << total_buckets << "\n"
+        << "Block Size: " << block_size << " bytes\n\n";
+
+    double total_occupancy = 0;
+    for (int i = 0; i < directory.size(); ++i)
+    {
+        oss << bucketAt(i).toString() << "\n";
+        total_occupancy += bucketAt(i).getOccupancy();
+    }
+
+    oss << "\nAverage Occupancy: "
+        << (total_occupancy / directory.size() * 100) << "%\n";
+
+    LOG_INFO(&logger, oss.str());
+}
+
+void ExtendibleHash::printStatistics() const
+{
+    // Spread of the bucket fill, to compare hash functions on a data set
+    double min_occupancy = 1.0, max_occupancy = 0.0, sum = 0.0, sum_squares = 0.0;
+    int live = 0, empty = 0;
+    std::vector<bool> seen(buckets.size(), false);
+    for (int i = 0; i < directory.size(); ++i)
+    {
+        int page_id = directory.get(i);
+        if (seen[page_id])
+        {
+            continue;
+        }
+        seen[page_id] = true;
+        double occupancy = buckets[page_id].getOccupancy();
+        min_occupancy = std::min(min_occupancy, occupancy);
+        max_occupancy = std::max(max_occupancy, occupancy);
+        sum += occupancy;
+        sum_squares += occupancy * occupancy;
+        live++;
+        empty += buckets[page_id].record_count == 0;
+    }
+    double mean = live > 0 ? sum / live : 0.0;
+    double stddev = live > 0 ? std::sqrt(std::max(0.0, sum_squares / live - mean * mean)) : 0.0;
+
+    std::ostringstream oss;
+    oss << "\n=== HASH STATISTICS ===\n"
+        << "Hash Function: " << KeyHash::name(hash_function) << "\n"
+        << "Records: " << total_records << "\n"
+        << "Blocks Read: " << blocks_read << "\n"
+        << "Blocks Written: " << blocks_written << "\n"
+        << "Total Buckets: " << total_buckets << "\n"
+        << "Splits Performed: " << splits_performed << "\n"
+        << "Merges Performed: " << merges_performed << "\n"
+        << "Filter Rejects: " << filter_rejects << "\n"
+        << "Overflow Pages: " << overflow_pages << "\n"
+        << "Group Commits: " << wal.getCommits() << " (" << wal.getPagesLogged() << " pages, "
+        << wal.getBytesLogged() << " bytes logged)\n"
+        << "Checkpoints: " << checkpoints << "\n"
+        << "Global Depth: " << global_depth << "\n"
+        << "Load Factor: " << getLoadFactor() << "\n"
+        << "Bucket Occupancy: min " << min_occupancy * 100 << "% mean " << mean * 100
+        << "% max " << max_occupancy * 100 << "% stddev " << stddev * 100 << "%\n"
+        << "Empty Buckets: " << empty << "\n";
+
+    LOG_INFO(&logger, oss.str());
+}
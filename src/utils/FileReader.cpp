@@ -1,4 +1,5 @@
 #include "FileReader.hpp"
+#include <cstring>
 
 
 FileReader* FileReader::reader = nullptr;
@@ -18,19 +19,63 @@ int FileReader::getCurrentLine() const {
     return cur_lines;
 }
 
-std::vector<std::string> FileReader::line_processed(){
-    std::vector<std::string> tokens;
-    std::string token;
+// Drops the rows already handed out, keeps the partial row at the front
+// of the buffer and reads until at least one more row is complete.
+// Returns false at the end of the file.
+bool FileReader::refill(){
+    size_t rest = filled - rows_end;
+    if(rest > 0 && rows_end > 0){
+        std::memmove(buffer.data(), buffer.data() + rows_end, rest);
+    }
+    filled = rest;
+    rows_end = 0;
+
+    while(true){
+        if(filled == buffer.size()){
+            buffer.resize(buffer.size() * 2); // a row longer than the buffer
+        }
+        size_t scanned = filled;
+        file_stream.read(buffer.data() + filled, buffer.size() - filled);
+        filled += file_stream.gcount();
+        bool eof = filled < buffer.size();
+
+        // A row ends at a newline outside quotes
+        structural.clear();
+        CsvScanner::scan(buffer.data() + scanned, filled - scanned, structural);
+        for(uint32_t offset : structural){
+            char c = buffer[scanned + offset];
+            if(c == '"'){
+                in_quotes = !in_quotes;
+            } else if(c == '\n' && !in_quotes){
+                rows_end = scanned + offset + 1;
+            }
+        }
+
+        if(eof){
+            rows_end = filled;
+            break;
+        }
+        if(rows_end > 0){
+            break;
+        }
+    }
+
+    scanner.reset(buffer.data(), rows_end);
+    return rows_end > 0;
+}
 
-    while(std::getline(file_stream,token,';')){
-        tokens.push_back(token);
+bool FileReader::nextRow(std::vector<std::string_view>& fields){
+    if(!scanner.nextRow(fields)){
+        if(!refill() || !scanner.nextRow(fields)){
+            return false;
+        }
     }
     cur_lines++;
-    return tokens;
+    return true;
 }
 
 bool FileReader::hasNextLine(){
-    return file_stream.peek()!=EOF;
+    return scanner.hasMore() || filled > rows_end || file_stream.peek()!=EOF;
 }
 
 
@@ -38,6 +83,10 @@ void FileReader::reset(){
     file_stream.clear();
     file_stream.seekg(0);
     cur_lines = 0;
+    filled = 0;
+    rows_end = 0;
+    in_quotes = false;
+    scanner.reset(buffer.data(), 0);
 }
 
 
@@ -0,0 +1,71 @@
+#include "HashDirectory.hpp"
+#include <algorithm>
+
+void HashDirectory::reset(int new_depth, int page)
+{
+    depth = new_depth;
+    segments.clear();
+    int count = std::max(1, size() >> SEGMENT_BITS);
+    for (int s = 0; s < count; ++s)
+    {
+        segments.emplace_back(new int[SEGMENT_SIZE]);
+        std::fill(segments.back().get(), segments.back().get() + SEGMENT_SIZE, page);
+    }
+}
+
+void HashDirectory::materialize(int segment)
+{
+    std::unique_ptr<int[]> entries(new int[SEGMENT_SIZE]);
+    int base = segment << SEGMENT_BITS;
+    for (int i = 0; i < SEGMENT_SIZE; ++i)
+    {
+        entries[i] = get(base + i);
+    }
+    segments[segment] = std::move(entries);
+}
+
+void HashDirectory::set(int index, int page)
+{
+    int segment = index >> SEGMENT_BITS;
+    if (!segments[segment])
+    {
+        materialize(segment);
+    }
+    // Segments mirroring this one must keep the value it had; each is
+    // filled in once, on the first write after a doubling
+    int count = segments.size();
+    for (int bit = segment ? 2 << (31 - __builtin_clz(segment)) : 1; bit < count; bit <<= 1)
+    {
+        if (!segments[segment | bit])
+        {
+            materialize(segment | bit);
+        }
+    }
+    segments[segment][index & (SEGMENT_SIZE - 1)] = page;
+}
+
+void HashDirectory::grow()
+{
+    int old_size = size();
+    depth++;
+    if (old_size < SEGMENT_SIZE)
+    {
+        int *entries = segments[0].get();
+        std::copy(entries, entries + old_size, entries + old_size);
+        return;
+    }
+    segments.resize(segments.size() * 2);
+}
+
+void HashDirectory::shrink()
+{
+    if (depth == 0)
+    {
+        return;
+    }
+    depth--;
+    if (size() >= SEGMENT_SIZE)
+    {
+        segments.resize(segments.size() / 2);
+    }
+}
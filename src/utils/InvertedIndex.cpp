@@ -0,0 +1,346 @@
+#include "InvertedIndex.hpp"
+#include "Collation.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+    template <typename T>
+    T readValue(const char *ptr)
+    {
+        T value = 0;
+        std::memcpy(&value, ptr, sizeof(T));
+        return value;
+    }
+
+    template <typename T>
+    void putValue(std::vector<char> &out, T value)
+    {
+        const char *bytes = reinterpret_cast<const char *>(&value);
+        out.insert(out.end(), bytes, bytes + sizeof(T));
+    }
+
+    // IDs are signed; flipping the sign bit keeps their order as unsigned
+    uint32_t toKey(int id) { return static_cast<uint32_t>(id) ^ 0x80000000u; }
+    int fromKey(uint32_t key) { return static_cast<int>(key ^ 0x80000000u); }
+
+    void putVarint(std::vector<char> &out, uint32_t value)
+    {
+        while (value >= 0x80)
+        {
+            out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<char>(value));
+    }
+
+    bool isTermByte(unsigned char c)
+    {
+        return (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c >= 0x80;
+    }
+
+    void intersect(std::vector<int> &acc, const std::vector<int> &other)
+    {
+        std::vector<int> result;
+        std::set_intersection(acc.begin(), acc.end(), other.begin(), other.end(),
+                              std::back_inserter(result));
+        acc.swap(result);
+    }
+}
+
+void InvertedIndex::tokenize(std::string_view text, std::vector<std::string> &out)
+{
+    std::string folded = Collation::fold(text);
+    size_t i = 0;
+    while (i < folded.size())
+    {
+        while (i < folded.size() && !isTermByte(static_cast<unsigned char>(folded[i])))
+            i++;
+        size_t begin = i;
+        while (i < folded.size() && isTermByte(static_cast<unsigned char>(folded[i])))
+            i++;
+        if (i - begin >= 2)
+        {
+            out.emplace_back(folded, begin, std::min(i - begin, static_cast<size_t>(MAX_TERM_SIZE)));
+        }
+    }
+}
+
+void InvertedIndex::Builder::add(int id, std::string_view text)
+{
+    terms.clear();
+    tokenize(text, terms);
+    for (const auto &term : terms)
+    {
+        std::vector<int> &ids = postings[term];
+        // A record repeating a term is added once
+        if (ids.empty() || ids.back() != id)
+        {
+            ids.push_back(id);
+        }
+    }
+}
+
+bool InvertedIndex::Builder::write(Logger &logger, const std::string &path)
+{
+    std::vector<const std::pair<const std::string, std::vector<int>> *> sorted;
+    sorted.reserve(postings.size());
+    for (auto &entry : postings)
+    {
+        sorted.push_back(&entry);
+    }
+    std::sort(sorted.begin(), sorted.end(),
+              [](const auto *a, const auto *b)
+              { return a->first < b->first; });
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out)
+    {
+        LOG_ERROR(&logger, "Could not create inverted index: " + path);
+        return false;
+    }
+
+    std::vector<char> header(HEADER_SIZE, 0);
+    out.write(header.data(), header.size());
+
+    // Posting lists, written as they are encoded
+    std::vector<char> table;
+    std::vector<char> pool;
+    std::vector<char> encoded;
+    table.reserve(sorted.size() * ENTRY_SIZE);
+    uint64_t offset = HEADER_SIZE;
+    for (const auto *entry : sorted)
+    {
+        std::vector<int> ids = entry->second;
+        // Records arrive in hash file order, not by ID
+        std::sort(ids.begin(), ids.end());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+
+        encoded.clear();
+        uint32_t previous = 0;
+        for (int id : ids)
+        {
+            putVarint(encoded, toKey(id) - previous);
+            previous = toKey(id);
+        }
+        out.write(encoded.data(), encoded.size());
+
+        putValue<uint64_t>(table, offset);
+        putValue<uint32_t>(table, static_cast<uint32_t>(pool.size()));
+        putValue<uint32_t>(table, static_cast<uint32_t>(ids.size()));
+        putValue<uint32_t>(table, static_cast<uint32_t>(encoded.size()));
+        putValue<uint16_t>(table, static_cast<uint16_t>(entry->first.size()));
+        putValue<uint16_t>(table, 0);
+        pool.insert(pool.end(), entry->first.begin(), entry->first.end());
+        offset += encoded.size();
+    }
+
+    uint64_t table_offset = offset;
+    uint64_t pool_offset = table_offset + table.size();
+    out.write(table.data(), table.size());
+    out.write(pool.data(), pool.size());
+
+    header.clear();
+    putValue<int32_t>(header, META_MAGIC);
+    putValue<int32_t>(header, META_VERSION);
+    putValue<int32_t>(header, static_cast<int32_t>(sorted.size()));
+    putValue<int32_t>(header, records);
+    putValue<uint64_t>(header, table_offset);
+    putValue<uint64_t>(header, pool_offset);
+    out.seekp(0);
+    out.write(header.data(), header.size());
+    out.close();
+    if (!out)
+    {
+        LOG_ERROR(&logger, "Failed to write inverted index: " + path);
+        return false;
+    }
+
+    std::ostringstream oss;
+    oss << "Inverted index built at " << path << " - Terms: " << sorted.size()
+        << " Records: " << records << " Bytes: " << pool_offset + pool.size();
+    LOG_INFO(&logger, oss.str());
+    return true;
+}
+
+InvertedIndex::InvertedIndex(Logger &log)
+    : logger(log), data(nullptr), size(0), mapped(false), term_count(0), record_count(0),
+      table_offset(0), pool_offset(0) {}
+
+InvertedIndex::~InvertedIndex()
+{
+    close();
+}
+
+bool InvertedIndex::open(const std::string &path)
+{
+    close();
+    file_path = path;
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    struct stat st;
+    if (fd < 0 || ::fstat(fd, &st) != 0 || st.st_size < HEADER_SIZE)
+    {
+        if (fd >= 0)
+            ::close(fd);
+        LOG_ERROR(&logger, "Could not open inverted index: " + path);
+        return false;
+    }
+    size = static_cast<size_t>(st.st_size);
+    void *addr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (addr != MAP_FAILED)
+    {
+        data = static_cast<const char *>(addr);
+        mapped = true;
+    }
+    else
+    {
+        owned.resize(size);
+        if (::pread(fd, owned.data(), size, 0) != static_cast<ssize_t>(size))
+        {
+            ::close(fd);
+            owned.clear();
+            size = 0;
+            LOG_ERROR(&logger, "Could not read inverted index: " + path);
+            return false;
+        }
+        data = owned.data();
+    }
+    ::close(fd);
+
+    term_count = readValue<int32_t>(data + 8);
+    record_count = readValue<int32_t>(data + 12);
+    table_offset = readValue<uint64_t>(data + 16);
+    pool_offset = readValue<uint64_t>(data + 24);
+    if (readValue<int32_t>(data) != META_MAGIC || readValue<int32_t>(data + 4) != META_VERSION ||
+        table_offset + static_cast<uint64_t>(term_count) * ENTRY_SIZE != pool_offset || pool_offset > size)
+    {
+        LOG_ERROR(&logger, "Invalid inverted index: " + path);
+        close();
+        return false;
+    }
+    return true;
+}
+
+void InvertedIndex::close()
+{
+    if (mapped)
+    {
+        ::munmap(const_cast<char *>(data), size);
+    }
+    mapped = false;
+    data = nullptr;
+    size = 0;
+    owned.clear();
+    term_count = 0;
+}
+
+std::string_view InvertedIndex::termAt(int index) const
+{
+    const char *entry = data + table_offset + static_cast<uint64_t>(index) * ENTRY_SIZE;
+    return std::string_view(data + pool_offset + readValue<uint32_t>(entry + 8),
+                            readValue<uint16_t>(entry + 20));
+}
+
+int InvertedIndex::findTerm(std::string_view term) const
+{
+    int lo = 0, hi = term_count - 1;
+    while (lo <= hi)
+    {
+        int mid = (lo + hi) / 2;
+        int cmp = termAt(mid).compare(term);
+        if (cmp == 0)
+            return mid;
+        if (cmp < 0)
+            lo = mid + 1;
+        else
+            hi = mid - 1;
+    }
+    return -1;
+}
+
+bool InvertedIndex::lookup(std::string_view term, std::vector<int> &out) const
+{
+    out.clear();
+    int index = data ? findTerm(term) : -1;
+    if (index < 0)
+    {
+        return false;
+    }
+
+    const char *entry = data + table_offset + static_cast<uint64_t>(index) * ENTRY_SIZE;
+    const unsigned char *ptr = reinterpret_cast<const unsigned char *>(data + readValue<uint64_t>(entry));
+    const unsigned char *end = ptr + readValue<uint32_t>(entry + 16);
+    out.reserve(readValue<uint32_t>(entry + 12));
+
+    uint32_t key = 0;
+    while (ptr < end)
+    {
+        uint32_t delta = 0;
+        int shift = 0;
+        while (ptr < end && (*ptr & 0x80))
+        {
+            delta |= static_cast<uint32_t>(*ptr++ & 0x7F) << shift;
+            shift += 7;
+        }
+        if (ptr < end)
+        {
+            delta |= static_cast<uint32_t>(*ptr++) << shift;
+        }
+        key += delta;
+        out.push_back(fromKey(key));
+    }
+    return true;
+}
+
+std::vector<int> InvertedIndex::query(const std::string &text, bool match_all) const
+{
+    std::vector<std::string> terms;
+    tokenize(text, terms);
+    std::sort(terms.begin(), terms.end());
+    terms.erase(std::unique(terms.begin(), terms.end()), terms.end());
+
+    std::vector<std::vector<int>> lists(terms.size());
+    for (size_t i = 0; i < terms.size(); ++i)
+    {
+        // A missing term empties an AND query right away
+        if (!lookup(terms[i], lists[i]) && match_all)
+        {
+            return std::vector<int>();
+        }
+    }
+    if (lists.empty())
+    {
+        return std::vector<int>();
+    }
+
+    std::vector<int> result;
+    if (match_all)
+    {
+        // Shortest list first keeps every intermediate result small
+        std::sort(lists.begin(), lists.end(),
+                  [](const std::vector<int> &a, const std::vector<int> &b)
+                  { return a.size() < b.size(); });
+        result.swap(lists[0]);
+        for (size_t i = 1; i < lists.size() && !result.empty(); ++i)
+        {
+            intersect(result, lists[i]);
+        }
+    }
+    else
+    {
+        for (const auto &list : lists)
+        {
+            result.insert(result.end(), list.begin(), list.end());
+        }
+        std::sort(result.begin(), result.end());
+        result.erase(std::unique(result.begin(), result.end()), result.end());
+    }
+    return result;
+}
@@ -0,0 +1,119 @@
+#include "KeyHash.hpp"
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#define KEY_HASH_SSE42 1
+#endif
+
+namespace
+{
+    const uint32_t CRC32C_POLY = 0x82F63B78U; // reflected Castagnoli
+
+    uint32_t crc32cSoftware(uint32_t key)
+    {
+        uint32_t crc = ~0U;
+        for (int byte = 0; byte < 4; ++byte)
+        {
+            crc ^= (key >> (byte * 8)) & 0xFF;
+            for (int bit = 0; bit < 8; ++bit)
+            {
+                crc = (crc >> 1) ^ (CRC32C_POLY & (0U - (crc & 1)));
+            }
+        }
+        return ~crc;
+    }
+
+    uint32_t crc32cSoftware(const char *data, size_t size)
+    {
+        uint32_t crc = ~0U;
+        for (size_t i = 0; i < size; ++i)
+        {
+            crc ^= static_cast<unsigned char>(data[i]);
+            for (int bit = 0; bit < 8; ++bit)
+            {
+                crc = (crc >> 1) ^ (CRC32C_POLY & (0U - (crc & 1)));
+            }
+        }
+        return ~crc;
+    }
+
+#ifdef KEY_HASH_SSE42
+    __attribute__((target("sse4.2"))) uint32_t crc32cHardware(uint32_t key)
+    {
+        return ~_mm_crc32_u32(~0U, key);
+    }
+
+    __attribute__((target("sse4.2"))) uint32_t crc32cHardware(const char *data, size_t size)
+    {
+        uint64_t crc = ~0U;
+        size_t i = 0;
+        for (; i + 8 <= size; i += 8)
+        {
+            uint64_t word;
+            std::memcpy(&word, data + i, 8);
+            crc = _mm_crc32_u64(crc, word);
+        }
+        uint32_t tail = static_cast<uint32_t>(crc);
+        for (; i < size; ++i)
+        {
+            tail = _mm_crc32_u8(tail, static_cast<unsigned char>(data[i]));
+        }
+        return ~tail;
+    }
+
+    const bool HAS_SSE42 = __builtin_cpu_supports("sse4.2");
+#endif
+}
+
+uint32_t KeyHash::crc32c(uint32_t key)
+{
+#ifdef KEY_HASH_SSE42
+    if (HAS_SSE42)
+    {
+        return crc32cHardware(key);
+    }
+#endif
+    return crc32cSoftware(key);
+}
+
+uint32_t KeyHash::crc32c(const char *data, size_t size)
+{
+#ifdef KEY_HASH_SSE42
+    if (HAS_SSE42)
+    {
+        return crc32cHardware(data, size);
+    }
+#endif
+    return crc32cSoftware(data, size);
+}
+
+bool KeyHash::parse(const std::string &name, Function &function)
+{
+    if (name == "identity")
+        function = Function::Identity;
+    else if (name == "murmur")
+        function = Function::Murmur;
+    else if (name == "xxh3")
+        function = Function::Xxh3;
+    else if (name == "crc32c")
+        function = Function::Crc32c;
+    else
+        return false;
+    return true;
+}
+
+const char *KeyHash::name(Function function)
+{
+    switch (function)
+    {
+    case Function::Murmur:
+        return "murmur";
+    case Function::Xxh3:
+        return "xxh3";
+    case Function::Crc32c:
+        return "crc32c";
+    default:
+        return "identity";
+    }
+}
@@ -0,0 +1,257 @@
+#include "PageFile.hpp"
+#include "Buffer.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace
+{
+    // Identifies the file in the buffer pool page table
+    std::atomic<int> next_file_id(0);
+}
+
+PageFile::PageFile(Logger &log, int pg_size)
+    : logger(log), page_size(pg_size), page_count(0), read_only(false),
+      file_id(next_file_id++), mapping(nullptr), mapping_size(0),
+      pages_read(0), pages_written(0) {}
+
+PageFile::~PageFile()
+{
+    close();
+}
+
+bool PageFile::open(const std::string &path, bool create, bool readonly)
+{
+    close();
+    file_path = path;
+    read_only = readonly && !create;
+
+    std::ios::openmode mode = std::ios::in | std::ios::binary;
+    if (create)
+    {
+        mode |= std::ios::out | std::ios::trunc;
+    }
+    else if (!read_only)
+    {
+        mode |= std::ios::out;
+    }
+
+    stream.open(path, mode);
+    if (!stream.is_open())
+    {
+        LOG_ERROR(&logger, "Could not open page file: " + path);
+        return false;
+    }
+
+    stream.seekg(0, std::ios::end);
+    std::streamoff file_size = stream.tellg();
+    page_count = static_cast<int>(file_size / page_size);
+
+    std::ostringstream oss;
+    oss << "PageFile opened: " << path << " Pages: " << page_count
+        << " Page Size: " << page_size << " bytes";
+    LOG_DEBUG(&logger, oss.str());
+    return true;
+}
+
+namespace
+{
+    int adviceFor(PageFile::Access access)
+    {
+        switch (access)
+        {
+        case PageFile::Access::Random:
+            return MADV_RANDOM;
+        case PageFile::Access::WillNeed:
+            return MADV_WILLNEED;
+        default:
+            return MADV_SEQUENTIAL;
+        }
+    }
+}
+
+bool PageFile::map(Access access)
+{
+    if (mapping)
+    {
+        advise(0, page_count, access);
+        return true;
+    }
+    if (!stream.is_open() || !read_only || page_count == 0)
+    {
+        return false;
+    }
+
+    int fd = ::open(file_path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        LOG_WARN(&logger, "Could not map " + file_path + ", using buffered reads");
+        return false;
+    }
+    size_t size = static_cast<size_t>(page_count) * page_size;
+    void *addr = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED)
+    {
+        LOG_WARN(&logger, "Could not map " + file_path + ", using buffered reads");
+        return false;
+    }
+
+    mapping = static_cast<char *>(addr);
+    mapping_size = size;
+    ::madvise(mapping, mapping_size, adviceFor(access));
+    LOG_DEBUG(&logger, "PageFile mapped: " + file_path);
+    return true;
+}
+
+void PageFile::advise(int first_page, int count, Access access)
+{
+    if (!mapping || first_page < 0 || first_page >= page_count || count <= 0)
+    {
+        return;
+    }
+    count = std::min(count, page_count - first_page);
+    // madvise wants a page-aligned start; pages are block_size aligned
+    // in the file, but block_size may be smaller than the OS page
+    size_t start = static_cast<size_t>(first_page) * page_size;
+    size_t os_page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    size_t aligned = start - start % os_page;
+    size_t length = start + static_cast<size_t>(count) * page_size - aligned;
+    ::madvise(mapping + aligned, length, adviceFor(access));
+}
+
+const char *PageFile::mappedPage(int page_id)
+{
+    if (!mapping || page_id < 0 || page_id >= page_count)
+    {
+        return nullptr;
+    }
+    pages_read++;
+    return mapping + static_cast<size_t>(page_id) * page_size;
+}
+
+bool PageFile::sync()
+{
+    if (!stream.is_open() || read_only)
+    {
+        return true;
+    }
+    stream.flush();
+    // fstream has no fsync; syncing another descriptor of the same
+    // file writes out all of its dirty data
+    int fd = ::open(file_path.c_str(), O_RDONLY);
+    bool ok = fd >= 0 && ::fsync(fd) == 0;
+    if (fd >= 0)
+    {
+        ::close(fd);
+    }
+    if (!ok)
+    {
+        LOG_ERROR(&logger, "Could not sync page file: " + file_path);
+    }
+    return ok && static_cast<bool>(stream);
+}
+
+bool PageFile::truncate(int pages)
+{
+    if (read_only || pages < 0 || pages > page_count)
+    {
+        return false;
+    }
+    stream.flush();
+    for (int page_id = pages; page_id < page_count; ++page_id)
+    {
+        Buffer::getBuffer()->discardPage(*this, page_id);
+    }
+    if (::truncate(file_path.c_str(), static_cast<off_t>(pages) * page_size) != 0)
+    {
+        LOG_ERROR(&logger, "Could not truncate page file: " + file_path);
+        return false;
+    }
+    page_count = pages;
+    return true;
+}
+
+void PageFile::close()
+{
+    if (mapping)
+    {
+        ::munmap(mapping, mapping_size);
+        mapping = nullptr;
+        mapping_size = 0;
+    }
+    if (stream.is_open())
+    {
+        Buffer::getBuffer()->dropFile(*this);
+        stream.flush();
+        stream.close();
+    }
+}
+
+void PageFile::flush()
+{
+    if (stream.is_open() && !read_only)
+    {
+        stream.flush();
+    }
+}
+
+bool PageFile::readPage(int page_id, char *buffer)
+{
+    if (page_id < 0 || page_id >= page_count)
+    {
+        LOG_ERROR(&logger, "Page " + std::to_string(page_id) + " out of bounds in " + file_path);
+        return false;
+    }
+    if (mapping)
+    {
+        std::memcpy(buffer, mappedPage(page_id), page_size);
+        return true;
+    }
+
+    stream.clear();
+    stream.seekg(static_cast<std::streamoff>(page_id) * page_size);
+    stream.read(buffer, page_size);
+    if (stream.gcount() != page_size)
+    {
+        LOG_ERROR(&logger, "Short read on page " + std::to_string(page_id) + " in " + file_path);
+        stream.clear();
+        return false;
+    }
+
+    pages_read++;
+    return true;
+}
+
+bool PageFile::writePage(int page_id, const char *buffer)
+{
+    if (read_only)
+    {
+        LOG_ERROR(&logger, "Write attempted on read-only page file: " + file_path);
+        return false;
+    }
+    if (page_id < 0)
+    {
+        return false;
+    }
+
+    stream.clear();
+    stream.seekp(static_cast<std::streamoff>(page_id) * page_size);
+    stream.write(buffer, page_size);
+    if (!stream)
+    {
+        LOG_ERROR(&logger, "Write failed on page " + std::to_string(page_id) + " in " + file_path);
+        stream.clear();
+        return false;
+    }
+
+    if (page_id >= page_count)
+    {
+        page_count = page_id + 1;
+    }
+    pages_written++;
+    return true;
+}
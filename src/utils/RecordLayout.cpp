@@ -0,0 +1,304 @@
+#include "RecordLayout.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+    void putBytes(std::vector<char> &out, const void *value, size_t size)
+    {
+        const char *bytes = static_cast<const char *>(value);
+        out.insert(out.end(), bytes, bytes + size);
+    }
+
+    std::string_view trimmed(std::string_view text)
+    {
+        size_t begin = text.find_first_not_of(" \t");
+        if (begin == std::string_view::npos)
+            return std::string_view();
+        size_t end = text.find_last_not_of(" \t");
+        return text.substr(begin, end - begin + 1);
+    }
+
+    bool isNull(std::string_view text)
+    {
+        return text.empty() || text == "NULL" || text == "null";
+    }
+
+    bool parseInt(std::string_view text, int32_t &value)
+    {
+        const char *end = text.data() + text.size();
+        auto result = std::from_chars(text.data(), end, value);
+        return result.ec == std::errc() && result.ptr == end;
+    }
+
+    // Days since 1970-01-01 in the proleptic Gregorian calendar
+    int64_t daysFromCivil(int64_t y, int m, int d)
+    {
+        y -= m <= 2;
+        int64_t era = (y >= 0 ? y : y - 399) / 400;
+        int64_t yoe = y - era * 400;
+        int64_t doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+        int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        return era * 146097 + doe - 719468;
+    }
+
+    void civilFromDays(int64_t z, int64_t &y, int &m, int &d)
+    {
+        z += 719468;
+        int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+        int64_t doe = z - era * 146097;
+        int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        int64_t mp = (5 * doy + 2) / 153;
+        d = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+        m = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+        y = yoe + era * 400 + (m <= 2);
+    }
+}
+
+RecordLayout::RecordLayout(const std::vector<FieldSpec> &schema)
+    : var_table(HEADER_SIZE), var_data(HEADER_SIZE)
+{
+    for (const auto &field : schema)
+    {
+        std::string type = field.type;
+        std::transform(type.begin(), type.end(), type.begin(), ::toupper);
+
+        Column column{field.name, Type::VarAlfa, field.size, 0};
+        if (type == "INT" || type == "INTE")
+        {
+            column.type = Type::Int;
+            column.width = 4;
+        }
+        else if (type == "DATAH")
+        {
+            column.type = Type::DateTime;
+            column.width = 8;
+        }
+        else if (type.find("VARALFA") != std::string::npos)
+        {
+            column.type = Type::VarAlfa;
+            column.width = std::min(field.max_size > 0 ? field.max_size : 0xFFFF, 0xFFFF);
+        }
+        else if (type.find("ALFA") != std::string::npos)
+        {
+            column.type = Type::Alfa;
+        }
+        columns.push_back(column);
+    }
+
+    // Fixed columns first, then one end entry per variable column
+    int offset = HEADER_SIZE;
+    for (auto &column : columns)
+    {
+        if (column.type != Type::VarAlfa)
+        {
+            column.offset = offset;
+            offset += column.width;
+        }
+    }
+    var_table = offset;
+    for (auto &column : columns)
+    {
+        if (column.type == Type::VarAlfa)
+        {
+            column.offset = offset;
+            offset += 2;
+        }
+    }
+    var_data = offset;
+}
+
+int RecordLayout::findColumn(const std::string &name) const
+{
+    for (size_t i = 0; i < columns.size(); ++i)
+    {
+        if (columns[i].name == name)
+            return static_cast<int>(i);
+    }
+    return -1;
+}
+
+bool RecordLayout::encode(const std::vector<std::string_view> &tokens, std::vector<char> &out,
+                          std::string &error) const
+{
+    if (columns.empty() || columns[0].type != Type::Int)
+    {
+        error = "first column must be an INT ID";
+        return false;
+    }
+    int32_t id = 0;
+    if (!parseInt(trimmed(tokens[0]), id))
+    {
+        error = "invalid ID \"" + std::string(tokens[0]) + "\"";
+        return false;
+    }
+
+    size_t start = out.size();
+    int32_t num_fields = static_cast<int32_t>(columns.size());
+    out.resize(start + var_data);
+    char *record = out.data() + start;
+    std::memcpy(record, &id, 4);
+    std::memcpy(record + 4, &num_fields, 4);
+
+    for (size_t i = 0; i < columns.size(); ++i)
+    {
+        const Column &column = columns[i];
+        std::string_view value = i < tokens.size() ? tokens[i] : std::string_view();
+        record = out.data() + start; // appending VARALFA values may move the buffer
+
+        switch (column.type)
+        {
+        case Type::Int:
+        {
+            int32_t number = NULL_INT;
+            std::string_view text = trimmed(value);
+            if (!isNull(text) && !parseInt(text, number))
+            {
+                error = column.name + ": invalid INT \"" + std::string(value) + "\"";
+                out.resize(start);
+                return false;
+            }
+            std::memcpy(record + column.offset, &number, 4);
+            break;
+        }
+        case Type::DateTime:
+        {
+            int64_t epoch = NULL_DATETIME;
+            std::string_view text = trimmed(value);
+            if (!isNull(text) && !parseDateTime(text, epoch))
+            {
+                error = column.name + ": invalid DATAH \"" + std::string(value) + "\"";
+                out.resize(start);
+                return false;
+            }
+            std::memcpy(record + column.offset, &epoch, 8);
+            break;
+        }
+        case Type::Alfa:
+        {
+            size_t used = std::min(value.size(), static_cast<size_t>(column.width));
+            std::memcpy(record + column.offset, value.data(), used);
+            std::memset(record + column.offset + used, 0, column.width - used);
+            break;
+        }
+        case Type::VarAlfa:
+        {
+            size_t used = std::min(value.size(), static_cast<size_t>(column.width));
+            if (out.size() - start + used > 0xFFFF)
+            {
+                error = column.name + ": record larger than 64 KiB";
+                out.resize(start);
+                return false;
+            }
+            putBytes(out, value.data(), used);
+            uint16_t end = static_cast<uint16_t>(out.size() - start);
+            std::memcpy(out.data() + start + column.offset, &end, 2);
+            break;
+        }
+        }
+    }
+
+    int32_t total_size = static_cast<int32_t>(out.size() - start);
+    std::memcpy(out.data() + start + 8, &total_size, 4);
+    return true;
+}
+
+bool RecordLayout::validate(const char *record, int size) const
+{
+    if (!record || size < var_data)
+        return false;
+    int32_t num_fields = 0;
+    std::memcpy(&num_fields, record + 4, 4);
+    if (num_fields != getColumnCount())
+        return false;
+
+    // End offsets must not decrease or run past the record
+    int previous = var_data;
+    for (int offset = var_table; offset < var_data; offset += 2)
+    {
+        int end = readOffset(record + offset);
+        if (end < previous || end > size)
+            return false;
+        previous = end;
+    }
+    return true;
+}
+
+std::string RecordLayout::format(int column, std::string_view bytes) const
+{
+    if (column < 0 || column >= getColumnCount())
+        return std::string();
+
+    switch (columns[column].type)
+    {
+    case Type::Int:
+    {
+        int32_t number = NULL_INT;
+        if (bytes.size() == 4)
+            std::memcpy(&number, bytes.data(), 4);
+        return number == NULL_INT ? "NULL" : std::to_string(number);
+    }
+    case Type::DateTime:
+    {
+        int64_t epoch = NULL_DATETIME;
+        if (bytes.size() == 8)
+            std::memcpy(&epoch, bytes.data(), 8);
+        return epoch == NULL_DATETIME ? "NULL" : formatDateTime(epoch);
+    }
+    default:
+        return std::string(bytes);
+    }
+}
+
+/**
+ * "YYYY-MM-DD HH:MM:SS" (or just the date) to seconds since the epoch
+ */
+bool RecordLayout::parseDateTime(std::string_view text, int64_t &epoch)
+{
+    if (text.size() != 10 && text.size() != 19)
+        return false;
+
+    auto number = [&](size_t pos, size_t len, int &value)
+    {
+        return std::from_chars(text.data() + pos, text.data() + pos + len, value).ptr == text.data() + pos + len;
+    };
+
+    int year = 0, month = 0, day = 0, hour = 0, minute = 0, second = 0;
+    if (text[4] != '-' || text[7] != '-' ||
+        !number(0, 4, year) || !number(5, 2, month) || !number(8, 2, day))
+        return false;
+    if (text.size() == 19)
+    {
+        if ((text[10] != ' ' && text[10] != 'T') || text[13] != ':' || text[16] != ':' ||
+            !number(11, 2, hour) || !number(14, 2, minute) || !number(17, 2, second))
+            return false;
+    }
+    if (month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 || minute > 59 || second > 60)
+        return false;
+
+    epoch = daysFromCivil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second;
+    return true;
+}
+
+std::string RecordLayout::formatDateTime(int64_t epoch)
+{
+    int64_t days = epoch / 86400;
+    int64_t rest = epoch % 86400;
+    if (rest < 0)
+    {
+        rest += 86400;
+        days--;
+    }
+    int64_t year = 0;
+    int month = 0, day = 0;
+    civilFromDays(days, year, month, day);
+
+    char text[32];
+    std::snprintf(text, sizeof(text), "%04lld-%02d-%02d %02d:%02d:%02d",
+                  static_cast<long long>(year), month, day,
+                  static_cast<int>(rest / 3600), static_cast<int>(rest / 60 % 60), static_cast<int>(rest % 60));
+    return text;
+}
@@ -1,3 +1,5 @@
+#include "SchemaParser.hpp"
+
 void SchemaParser::trim(std::string &str)
 {
     str.erase(0, str.find_first_not_of(" \t\n\r"));
@@ -48,10 +50,6 @@ void SchemaParser::parseFieldDefinition(const std::string &field_def)
     {
         size = 8;
     }
-    else if (upper_type.find("ALFA") != std::string::npos)
-    {
-        size = parseSize(field_def);
-    }
     else if (upper_type.find("VARALFA") != std::string::npos)
     {
         std::regex var_pattern(R"(VARALFA\s*\(\s*(\d+)\s*,\s*(\d+)\s*\))");
@@ -64,6 +62,10 @@ void SchemaParser::parseFieldDefinition(const std::string &field_def)
             size = max_size;
         }
     }
+    else if (upper_type.find("ALFA") != std::string::npos)
+    {
+        size = parseSize(field_def);
+    }
 
     fields.emplace_back(name, type, size, min_size, max_size);
 
@@ -99,7 +101,7 @@ bool SchemaParser::parseSchema(const std::string &schema_file)
     table_name = match[1];
     std::string fields_str = match[2];
 
-    std::regex field_pattern(R"((\w+\s+(?:INT|INTE|ALFA|VARALFA|DATAH)[^,]*))");
+    std::regex field_pattern(R"((\w+\s+(?:INTE|INT|VARALFA|ALFA|DATAH)\s*(?:\([^)]*\))?))");
     std::sregex_iterator iter(fields_str.begin(), fields_str.end(), field_pattern);
     std::sregex_iterator end;
 
@@ -205,7 +207,15 @@ void DBManager::printConfig() const
         << "Record Size: " << config.record_size << " bytes\n"
         << "Max Records per Block: " << config.max_records_per_block << "\n"
         << "Load Factor: " << config.load_factor << "\n"
-        << "Initial Hash Buckets: " << config.initial_buckets << "\n";
+        << "Index Fill Factor: " << config.index_fill_factor << "\n"
+        << "Initial Hash Buckets: " << config.initial_buckets << "\n"
+        << "Max Hash Depth: " << config.max_global_depth << "\n"
+        << "Buffer Frames: " << config.buffer_frames << "\n"
+        << "Memory-mapped Lookups: " << (config.use_mmap ? "yes" : "no") << "\n"
+        << "Loader Threads: " << (config.loader_threads > 0 ? std::to_string(config.loader_threads) : "auto") << "\n"
+        << "Split Policy: " << config.split_policy << "\n"
+        << "Hash Function: " << config.hash_function << "\n"
+        << "Group Commit: " << (config.group_size > 0 ? std::to_string(config.group_size) + " operations" : "off") << "\n";
 
     LOG_INFO(&logger, oss.str());
 }
\ No newline at end of file
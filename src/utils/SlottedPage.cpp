@@ -0,0 +1,144 @@
+#include "SlottedPage.hpp"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+int SlottedPage::readField(int offset) const
+{
+    int value = 0;
+    std::memcpy(&value, data + offset, 4);
+    return value;
+}
+
+void SlottedPage::writeField(int offset, int value)
+{
+    std::memcpy(data + offset, &value, 4);
+}
+
+void SlottedPage::format(char *page, int size, int aux)
+{
+    std::memset(page, 0, size);
+    SlottedPage sp(page, size);
+    sp.writeField(0, 0);
+    sp.writeField(4, size);
+    sp.writeField(8, 0);
+    sp.writeField(12, 0);
+    sp.writeField(16, aux);
+    sp.writeField(20, -1);
+}
+
+int SlottedPage::getContiguousFree() const
+{
+    return readField(4) - slotOffset(getSlotCount());
+}
+
+int SlottedPage::getFreeSpace() const
+{
+    // Everything not used by live records or slot entries
+    return page_size - HEADER_SIZE - getSlotCount() * SLOT_SIZE - getLiveBytes();
+}
+
+int SlottedPage::insert(const char *record, int length)
+{
+    int slot_count = getSlotCount();
+
+    // Reuse an empty slot if there is one, otherwise append a new entry
+    int slot = slot_count;
+    for (int i = 0; i < slot_count; ++i)
+    {
+        if (readField(slotOffset(i) + 4) == 0)
+        {
+            slot = i;
+            break;
+        }
+    }
+    int needed = length + (slot == slot_count ? SLOT_SIZE : 0);
+
+    if (getFreeSpace() < needed)
+    {
+        return -1;
+    }
+    if (getContiguousFree() < needed)
+    {
+        compact();
+    }
+
+    int free_end = readField(4) - length;
+    std::memcpy(data + free_end, record, length);
+    writeField(4, free_end);
+    writeField(slotOffset(slot), free_end);
+    writeField(slotOffset(slot) + 4, length);
+
+    if (slot == slot_count)
+    {
+        writeField(0, slot_count + 1);
+    }
+    writeField(8, getLiveRecords() + 1);
+    writeField(12, getLiveBytes() + length);
+    return slot;
+}
+
+const char *SlottedPage::get(int slot, int &length) const
+{
+    if (slot < 0 || slot >= getSlotCount())
+    {
+        length = 0;
+        return nullptr;
+    }
+    length = readField(slotOffset(slot) + 4);
+    return length > 0 ? data + readField(slotOffset(slot)) : nullptr;
+}
+
+bool SlottedPage::remove(int slot)
+{
+    int length = 0;
+    if (!get(slot, length))
+    {
+        return false;
+    }
+
+    writeField(slotOffset(slot), 0);
+    writeField(slotOffset(slot) + 4, 0);
+    writeField(8, getLiveRecords() - 1);
+    writeField(12, getLiveBytes() - length);
+
+    // Trailing empty slots are dropped so the slot array can shrink
+    int slot_count = getSlotCount();
+    while (slot_count > 0 && readField(slotOffset(slot_count - 1) + 4) == 0)
+    {
+        slot_count--;
+    }
+    writeField(0, slot_count);
+    if (slot_count == 0)
+    {
+        writeField(4, page_size);
+    }
+    return true;
+}
+
+void SlottedPage::compact()
+{
+    int slot_count = getSlotCount();
+
+    // Move records to the page end in decreasing offset order, so a
+    // record never overwrites one that has not been moved yet
+    std::vector<std::pair<int, int>> order; // (offset, slot)
+    for (int i = 0; i < slot_count; ++i)
+    {
+        if (readField(slotOffset(i) + 4) > 0)
+        {
+            order.emplace_back(readField(slotOffset(i)), i);
+        }
+    }
+    std::sort(order.rbegin(), order.rend());
+
+    int free_end = page_size;
+    for (const auto &entry : order)
+    {
+        int length = readField(slotOffset(entry.second) + 4);
+        free_end -= length;
+        std::memmove(data + free_end, data + entry.first, length);
+        writeField(slotOffset(entry.second), free_end);
+    }
+    writeField(4, free_end);
+}
@@ -0,0 +1,221 @@
+#include "WriteAheadLog.hpp"
+#include "KeyHash.hpp"
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace
+{
+    int readInt(const char *ptr)
+    {
+        int value = 0;
+        std::memcpy(&value, ptr, 4);
+        return value;
+    }
+
+    void writeInt(char *ptr, int value)
+    {
+        std::memcpy(ptr, &value, 4);
+    }
+}
+
+WriteAheadLog::WriteAheadLog(Logger &log)
+    : logger(log), fd(-1), next_lsn(0), log_size(0), commits(0), pages_logged(0), bytes_logged(0) {}
+
+WriteAheadLog::~WriteAheadLog()
+{
+    close();
+}
+
+bool WriteAheadLog::open(const std::string &path, long long first_lsn)
+{
+    close();
+    log_path = path;
+    fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+    if (fd < 0)
+    {
+        LOG_ERROR(&logger, "Could not open write-ahead log: " + path);
+        return false;
+    }
+    next_lsn = first_lsn;
+    log_size = 0;
+    pending.clear();
+    LOG_DEBUG(&logger, "Write-ahead log opened: " + path);
+    return true;
+}
+
+void WriteAheadLog::close()
+{
+    if (fd >= 0)
+    {
+        ::close(fd);
+        fd = -1;
+    }
+    pending.clear();
+}
+
+void WriteAheadLog::append(RecordType type, int page_id, const char *data, int size)
+{
+    size_t at = pending.size();
+    pending.resize(at + RECORD_HEADER + size);
+    char *record = pending.data() + at;
+    writeInt(record + 4, type);
+    std::memcpy(record + 8, &next_lsn, 8);
+    writeInt(record + 16, page_id);
+    writeInt(record + 20, size);
+    std::memcpy(record + RECORD_HEADER, data, size);
+    writeInt(record, static_cast<int>(KeyHash::crc32c(record + 4, RECORD_HEADER - 4 + size)));
+    next_lsn++;
+}
+
+void WriteAheadLog::logPage(int page_id, const char *data, int size)
+{
+    append(PAGE, page_id, data, size);
+    pages_logged++;
+}
+
+bool WriteAheadLog::commit(const std::string &changes)
+{
+    if (fd < 0)
+    {
+        return false;
+    }
+    append(COMMIT, -1, changes.data(), static_cast<int>(changes.size()));
+
+    // One write and one sync for the whole group
+    const char *data = pending.data();
+    size_t left = pending.size();
+    while (left > 0)
+    {
+        ssize_t written = ::write(fd, data, left);
+        if (written < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (written < 0)
+        {
+            LOG_ERROR(&logger, "Could not write to write-ahead log: " + log_path);
+            return discardGroup();
+        }
+        data += written;
+        left -= written;
+    }
+    if (::fdatasync(fd) != 0)
+    {
+        LOG_ERROR(&logger, "Could not sync write-ahead log: " + log_path);
+        return discardGroup();
+    }
+    bytes_logged += pending.size();
+    log_size += pending.size();
+    pending.clear();
+    commits++;
+    return true;
+}
+
+bool WriteAheadLog::discardGroup()
+{
+    // A partial group would hide every later group from replay, and its
+    // LSNs are handed out again
+    std::memcpy(&next_lsn, pending.data() + 8, 8);
+    pending.clear();
+    if (::ftruncate(fd, log_size) != 0)
+    {
+        LOG_ERROR(&logger, "Could not cut a failed group off the write-ahead log: " + log_path);
+    }
+    return false;
+}
+
+bool WriteAheadLog::truncate()
+{
+    pending.clear();
+    if (fd < 0 || ::ftruncate(fd, 0) != 0 || ::fdatasync(fd) != 0)
+    {
+        LOG_ERROR(&logger, "Could not truncate write-ahead log: " + log_path);
+        return false;
+    }
+    log_size = 0;
+    return true;
+}
+
+int WriteAheadLog::replay(Logger &log, const std::string &path, long long after_lsn,
+                          const std::function<bool(int page_id, const char *data, int size)> &apply_page,
+                          const std::function<bool(long long lsn, const char *data, int size)> &apply_commit)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open())
+    {
+        return 0;
+    }
+
+    // Page images of the group being read: (page id, offset in images)
+    std::vector<std::pair<int, size_t>> group;
+    std::vector<char> images;
+    std::vector<char> record;
+    long long expected_lsn = -1;
+    int groups = 0;
+    while (true)
+    {
+        record.resize(RECORD_HEADER);
+        if (!in.read(record.data(), RECORD_HEADER))
+        {
+            break;
+        }
+        int type = readInt(record.data() + 4);
+        long long lsn = 0;
+        std::memcpy(&lsn, record.data() + 8, 8);
+        int page_id = readInt(record.data() + 16);
+        int size = readInt(record.data() + 20);
+        if ((type != PAGE && type != COMMIT) || size < 0 || (expected_lsn >= 0 && lsn != expected_lsn))
+        {
+            break;
+        }
+        record.resize(RECORD_HEADER + size);
+        if (!in.read(record.data() + RECORD_HEADER, size) ||
+            static_cast<uint32_t>(readInt(record.data())) !=
+                KeyHash::crc32c(record.data() + 4, RECORD_HEADER - 4 + size))
+        {
+            break;
+        }
+        expected_lsn = lsn + 1;
+
+        if (type == PAGE)
+        {
+            group.emplace_back(page_id, images.size());
+            images.insert(images.end(), record.begin() + RECORD_HEADER, record.end());
+            continue;
+        }
+
+        // Groups the owner's files already reflect
+        if (lsn <= after_lsn)
+        {
+            group.clear();
+            images.clear();
+            continue;
+        }
+        for (size_t i = 0; i < group.size(); ++i)
+        {
+            size_t end = i + 1 < group.size() ? group[i + 1].second : images.size();
+            if (!apply_page(group[i].first, images.data() + group[i].second,
+                            static_cast<int>(end - group[i].second)))
+            {
+                return -1;
+            }
+        }
+        if (!apply_commit(lsn, record.data() + RECORD_HEADER, size))
+        {
+            return -1;
+        }
+        group.clear();
+        images.clear();
+        groups++;
+    }
+
+    if (!group.empty())
+    {
+        LOG_WARN(&log, "Dropped " + std::to_string(group.size()) +
+                           " page images of an uncommitted group in " + path);
+    }
+    return groups;
+}